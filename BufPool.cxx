@@ -0,0 +1,364 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <BufPool.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    // Buffers are carved from slabs that are never returned to the heap.  Each
+    // thread keeps a short free list per size class; overflow and refills go
+    // through the shared list under a lock.
+
+    struct pool_class
+    {
+        mutex    lock;
+        buf_hdr *free;
+    };
+
+    struct pool_cache
+    {
+        buf_hdr  *free[BufClassCount];
+        unsigned  count[BufClassCount];
+
+        pool_cache(void);
+        ~pool_cache(void);
+    };
+
+    static pool_class         pool_classes[BufClassCount];
+    static atomic<uint64_t>   stat_allocs(0);
+    static atomic<uint64_t>   stat_frees(0);
+    static atomic<uint64_t>   stat_cache_hits(0);
+    static atomic<uint64_t>   stat_slabs(0);
+    static atomic<uint64_t>   stat_heap_allocs(0);
+    static thread_local pool_cache cache;
+
+    static size_t buf_stride(unsigned arg_cls)
+    {
+        size_t len = sizeof(buf_hdr) + BufClassBytes[arg_cls];
+
+        return (len + alignof(buf_hdr) - 1) & ~(alignof(buf_hdr) - 1);
+    }
+
+    static uint8_t * buf_data(buf_hdr *arg_hdr)
+    {
+        return (uint8_t *)(arg_hdr + 1);
+    }
+
+    static void pool_give(unsigned arg_cls, buf_hdr *arg_head, buf_hdr *arg_tail)
+    {
+        lock_guard<mutex> guard(pool_classes[arg_cls].lock);
+
+        arg_tail->next              = pool_classes[arg_cls].free;
+        pool_classes[arg_cls].free  = arg_head;
+    }
+
+    static buf_hdr * pool_take(unsigned arg_cls)
+    {
+        buf_hdr *head;
+        uint8_t *slab;
+        size_t   stride = buf_stride(arg_cls);
+
+        {
+            lock_guard<mutex> guard(pool_classes[arg_cls].lock);
+
+            head = pool_classes[arg_cls].free;
+
+            if (head != NULL)
+            {
+                pool_classes[arg_cls].free = head->next;
+                return head;
+            }
+        }
+
+        slab = (uint8_t *)malloc(stride * BufSlabBufs);
+
+        if (slab == NULL) throw bad_alloc();
+
+        stat_slabs.fetch_add(1, memory_order_relaxed);
+
+        // keep the first buffer, chain the rest into the calling thread's cache
+        for (unsigned i = 1 ; i < BufSlabBufs ; i++)
+        {
+            head       = (buf_hdr *)(slab + (i * stride));
+            head->cls  = arg_cls;
+            head->cap  = BufClassBytes[arg_cls];
+            head->next = cache.free[arg_cls];
+
+            cache.free[arg_cls] = head;
+            cache.count[arg_cls]++;
+        }
+
+        head      = (buf_hdr *)slab;
+        head->cls = arg_cls;
+        head->cap = BufClassBytes[arg_cls];
+
+        return head;
+    }
+
+    pool_cache::pool_cache(void)
+    {
+        for (unsigned i = 0 ; i < BufClassCount ; i++)
+        {
+            this->free[i]  = NULL;
+            this->count[i] = 0;
+        }
+    }
+
+    pool_cache::~pool_cache(void)
+    {
+        buf_hdr *tail;
+
+        for (unsigned i = 0 ; i < BufClassCount ; i++)
+        {
+            if (this->free[i] == NULL) continue;
+
+            for (tail = this->free[i] ; tail->next != NULL ; tail = tail->next) { }
+
+            pool_give(i, this->free[i], tail);
+
+            this->free[i]  = NULL;
+            this->count[i] = 0;
+        }
+    }
+
+    buf_hdr * BufPool::alloc(size_t arg_len)
+    {
+        buf_hdr *hdr = NULL;
+        unsigned cls;
+
+        stat_allocs.fetch_add(1, memory_order_relaxed);
+
+        for (cls = 0 ; cls < BufClassCount ; cls++)
+        {
+            if (arg_len <= BufClassBytes[cls]) break;
+        }
+
+        if (cls == BufClassCount)
+        {
+            stat_heap_allocs.fetch_add(1, memory_order_relaxed);
+
+            hdr = (buf_hdr *)malloc(sizeof(buf_hdr) + arg_len);
+
+            if (hdr == NULL) throw bad_alloc();
+
+            hdr->cls = BufClassHeap;
+            hdr->cap = arg_len;
+        }
+        else if (cache.free[cls] != NULL)
+        {
+            stat_cache_hits.fetch_add(1, memory_order_relaxed);
+
+            hdr              = cache.free[cls];
+            cache.free[cls]  = hdr->next;
+            cache.count[cls]--;
+        }
+        else
+        {
+            hdr = pool_take(cls);
+        }
+
+        new (&hdr->refs) atomic<uint32_t>(1);
+        hdr->len  = arg_len;
+        hdr->next = NULL;
+
+        return hdr;
+    }
+
+    void BufPool::release(buf_hdr *arg_hdr)
+    {
+        unsigned cls = arg_hdr->cls;
+        buf_hdr *keep;
+        buf_hdr *head;
+        buf_hdr *tail;
+
+        if (arg_hdr->refs.fetch_sub(1, memory_order_acq_rel) != 1) return;
+
+        stat_frees.fetch_add(1, memory_order_relaxed);
+
+        if (cls == BufClassHeap)
+        {
+            free(arg_hdr);
+            return;
+        }
+
+        arg_hdr->next    = cache.free[cls];
+        cache.free[cls]  = arg_hdr;
+        cache.count[cls]++;
+
+        if (cache.count[cls] < BufCacheMax) return;
+
+        // hand half of an overfull cache back to the shared list
+        keep = cache.free[cls];
+
+        for (unsigned i = 1 ; i < BufCacheMax / 2 ; i++) keep = keep->next;
+
+        head       = keep->next;
+        keep->next = NULL;
+
+        for (tail = head ; tail->next != NULL ; tail = tail->next) { }
+
+        pool_give(cls, head, tail);
+
+        cache.count[cls] = BufCacheMax / 2;
+    }
+
+    void BufPool::get_stats(pool_stats &arg_stats)
+    {
+        arg_stats.allocs      = stat_allocs.load(memory_order_relaxed);
+        arg_stats.frees       = stat_frees.load(memory_order_relaxed);
+        arg_stats.cache_hits  = stat_cache_hits.load(memory_order_relaxed);
+        arg_stats.slabs       = stat_slabs.load(memory_order_relaxed);
+        arg_stats.heap_allocs = stat_heap_allocs.load(memory_order_relaxed);
+    }
+
+    Buf::Buf(void)
+    {
+        this->hdr = NULL;
+    }
+
+    Buf::Buf(size_t arg_len)
+    {
+        this->hdr = BufPool::alloc(arg_len);
+    }
+
+    Buf::Buf(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        this->hdr = BufPool::alloc(arg_len);
+
+        memcpy(buf_data(this->hdr), arg_bytes, arg_len);
+    }
+
+    Buf::Buf(const Buf &arg_buf)
+    {
+        this->hdr = arg_buf.hdr;
+
+        if (this->hdr != NULL) this->hdr->refs.fetch_add(1, memory_order_relaxed);
+    }
+
+    Buf::Buf(Buf &&arg_buf)
+    {
+        this->hdr    = arg_buf.hdr;
+        arg_buf.hdr  = NULL;
+    }
+
+    Buf::~Buf(void)
+    {
+        this->reset();
+    }
+
+    Buf & Buf::operator=(const Buf &arg_buf)
+    {
+        if (arg_buf.hdr != NULL) arg_buf.hdr->refs.fetch_add(1, memory_order_relaxed);
+
+        this->reset();
+        this->hdr = arg_buf.hdr;
+
+        return *this;
+    }
+
+    Buf & Buf::operator=(Buf &&arg_buf)
+    {
+        if (this != &arg_buf)
+        {
+            this->reset();
+            this->hdr   = arg_buf.hdr;
+            arg_buf.hdr = NULL;
+        }
+
+        return *this;
+    }
+
+    uint8_t * Buf::data(void)
+    {
+        return (this->hdr == NULL) ? NULL : buf_data(this->hdr);
+    }
+
+    const uint8_t * Buf::data(void) const
+    {
+        return (this->hdr == NULL) ? NULL : buf_data(this->hdr);
+    }
+
+    size_t Buf::size(void) const
+    {
+        return (this->hdr == NULL) ? 0 : this->hdr->len;
+    }
+
+    size_t Buf::capacity(void) const
+    {
+        return (this->hdr == NULL) ? 0 : this->hdr->cap;
+    }
+
+    bool Buf::empty(void) const
+    {
+        return (this->size() == 0);
+    }
+
+    unsigned Buf::refs(void) const
+    {
+        return (this->hdr == NULL) ? 0 : this->hdr->refs.load(memory_order_relaxed);
+    }
+
+    void Buf::resize(size_t arg_len)
+    {
+        buf_hdr *grow;
+
+        // a shared buffer is never written through, so resizing one unshares it
+        if ((this->hdr != NULL) and (arg_len <= this->hdr->cap) and (this->refs() == 1))
+        {
+            this->hdr->len = arg_len;
+            return;
+        }
+
+        grow = BufPool::alloc(arg_len);
+
+        if (this->hdr != NULL)
+        {
+            memcpy(buf_data(grow), buf_data(this->hdr), (this->hdr->len < arg_len) ? this->hdr->len : arg_len);
+        }
+
+        this->reset();
+        this->hdr = grow;
+    }
+
+    void Buf::assign(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        if ((this->hdr == NULL) or (arg_len > this->hdr->cap) or (this->refs() != 1))
+        {
+            this->reset();
+            this->hdr = BufPool::alloc(arg_len);
+        }
+
+        this->hdr->len = arg_len;
+
+        memcpy(buf_data(this->hdr), arg_bytes, arg_len);
+    }
+
+    void Buf::reset(void)
+    {
+        if (this->hdr != NULL) BufPool::release(this->hdr);
+
+        this->hdr = NULL;
+    }
+}
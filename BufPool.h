@@ -0,0 +1,92 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_BUF_POOL_H_
+    #define _FRAME_BUF_POOL_H_
+
+    #include <atomic>
+    #include <cstddef>
+    #include <cstdint>
+
+    namespace Frames
+    {
+        const unsigned BufClassCount        = 3;
+        const uint32_t BufClassBytes[]      = {128, 2048, 9216};
+        const uint8_t  BufClassHeap         = 0xFF;
+        const unsigned BufSlabBufs          = 64;
+        const unsigned BufCacheMax          = 256;
+
+        struct buf_hdr
+        {
+            std::atomic<uint32_t> refs;
+            uint32_t              len;
+            uint32_t              cap;
+            uint8_t               cls;
+            buf_hdr              *next;
+        };
+
+        struct pool_stats
+        {
+            uint64_t allocs;
+            uint64_t frees;
+            uint64_t cache_hits;
+            uint64_t slabs;
+            uint64_t heap_allocs;
+        };
+
+        class BufPool
+        {
+            public:
+                static buf_hdr * alloc(std::size_t arg_len);
+                static void release(buf_hdr *arg_hdr);
+                static void get_stats(pool_stats &arg_stats);
+        };
+
+        // A refcounted handle on a pooled buffer; copies share the bytes.  Bufs
+        // carry frames through the nic transmit queue, nic_rx_bufs() and
+        // share_frame(); a Frame itself still builds into its own BVec.
+
+        class Buf
+        {
+            private:
+                buf_hdr *hdr;
+
+            public:
+                Buf(void);
+                explicit Buf(std::size_t arg_len);
+                Buf(const uint8_t *arg_bytes, std::size_t arg_len);
+                Buf(const Buf &arg_buf);
+                Buf(Buf &&arg_buf);
+                ~Buf(void);
+
+                Buf & operator=(const Buf &arg_buf);
+                Buf & operator=(Buf &&arg_buf);
+
+                uint8_t * data(void);
+                const uint8_t * data(void) const;
+                std::size_t size(void) const;
+                std::size_t capacity(void) const;
+                bool empty(void) const;
+                unsigned refs(void) const;
+                void resize(std::size_t arg_len);
+                void assign(const uint8_t *arg_bytes, std::size_t arg_len);
+                void reset(void);
+        };
+    }
+#endif
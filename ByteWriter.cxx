@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <ByteWriter.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    ByteWriter::ByteWriter(uint8_t *arg_ptr, size_t arg_cap)
+    {
+        this->vec  = nullptr;
+        this->base = 0;
+        this->ptr  = arg_ptr;
+        this->cap  = arg_cap;
+        this->pos  = 0;
+    }
+
+    ByteWriter::ByteWriter(vector<uint8_t> &arg_vec, size_t arg_reserve)
+    {
+        this->vec  = &arg_vec;
+        this->base = arg_vec.size();
+        this->cap  = arg_reserve;
+        this->pos  = 0;
+
+        arg_vec.resize(this->base + arg_reserve);
+
+        this->ptr  = arg_vec.data() + this->base;
+    }
+
+    ByteWriter::~ByteWriter(void)
+    {
+        this->finish();
+    }
+
+    void ByteWriter::finish(void)
+    {
+        if (this->vec == nullptr) return;
+
+        this->vec->resize(this->base + this->pos);
+        this->vec = nullptr;
+    }
+
+    void ByteWriter::overflow(size_t arg_len)
+    {
+        cerr << "[ERR] ByteWriter: writing " << arg_len << " bytes at " << this->pos << " overruns " << this->cap << endl << flush;
+        exit(1);
+    }
+}
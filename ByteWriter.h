@@ -0,0 +1,275 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_BYTE_WRITER_H_
+    #define _FRAME_BYTE_WRITER_H_
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <vector>
+
+    namespace Frames
+    {
+        inline uint16_t to_be16(uint16_t arg_val)
+        {
+            #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                return __builtin_bswap16(arg_val);
+            #else
+                return arg_val;
+            #endif
+        }
+
+        inline uint32_t to_be32(uint32_t arg_val)
+        {
+            #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                return __builtin_bswap32(arg_val);
+            #else
+                return arg_val;
+            #endif
+        }
+
+        inline uint64_t to_be64(uint64_t arg_val)
+        {
+            #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                return __builtin_bswap64(arg_val);
+            #else
+                return arg_val;
+            #endif
+        }
+
+        // Stores the low W bytes of a value big-endian.  The common widths are
+        // one byte swap and one memcpy.
+
+        template <unsigned W>
+        struct be_store
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                for (unsigned i = 0 ; i < W ; ++i)
+                {
+                    arg_ptr[i] = (uint8_t)(arg_val >> (8 * (W - 1 - i)));
+                }
+            }
+        };
+
+        template <>
+        struct be_store<1>
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                arg_ptr[0] = (uint8_t)arg_val;
+            }
+        };
+
+        template <>
+        struct be_store<2>
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                uint16_t val = to_be16((uint16_t)arg_val);
+
+                memcpy(arg_ptr, &val, 2);
+            }
+        };
+
+        template <>
+        struct be_store<4>
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                uint32_t val = to_be32((uint32_t)arg_val);
+
+                memcpy(arg_ptr, &val, 4);
+            }
+        };
+
+        template <>
+        struct be_store<6>
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                uint64_t val = to_be64(arg_val << 16);
+
+                memcpy(arg_ptr, &val, 6);
+            }
+        };
+
+        template <>
+        struct be_store<8>
+        {
+            static void put(uint8_t *arg_ptr, uint64_t arg_val)
+            {
+                uint64_t val = to_be64(arg_val);
+
+                memcpy(arg_ptr, &val, 8);
+            }
+        };
+
+        // runtime width, 0 to 8 bytes
+        inline void be_put(uint8_t *arg_ptr, uint64_t arg_val, unsigned arg_len)
+        {
+            uint64_t val;
+
+            if (arg_len == 0) return;
+
+            val = to_be64(arg_val << (8 * (8 - arg_len)));
+            memcpy(arg_ptr, &val, arg_len);
+        }
+
+        // Reads W bytes big-endian; the counterpart of be_store.
+
+        template <unsigned W>
+        struct be_load
+        {
+            static uint64_t get(const uint8_t *arg_ptr)
+            {
+                uint64_t val = 0;
+
+                for (unsigned i = 0 ; i < W ; ++i)
+                {
+                    val = (val << 8) | arg_ptr[i];
+                }
+
+                return val;
+            }
+        };
+
+        template <>
+        struct be_load<1>
+        {
+            static uint8_t get(const uint8_t *arg_ptr)
+            {
+                return arg_ptr[0];
+            }
+        };
+
+        template <>
+        struct be_load<2>
+        {
+            static uint16_t get(const uint8_t *arg_ptr)
+            {
+                uint16_t val;
+
+                memcpy(&val, arg_ptr, 2);
+
+                return to_be16(val);
+            }
+        };
+
+        template <>
+        struct be_load<4>
+        {
+            static uint32_t get(const uint8_t *arg_ptr)
+            {
+                uint32_t val;
+
+                memcpy(&val, arg_ptr, 4);
+
+                return to_be32(val);
+            }
+        };
+
+        template <>
+        struct be_load<8>
+        {
+            static uint64_t get(const uint8_t *arg_ptr)
+            {
+                uint64_t val;
+
+                memcpy(&val, arg_ptr, 8);
+
+                return to_be64(val);
+            }
+        };
+
+        // Sequential writer over a fixed span.  The BVec form grows the vector
+        // once by arg_reserve bytes and trims it back to what was written on
+        // finish() or destruction, so building a header is a run of stores
+        // with no per-byte push_back.
+
+        class ByteWriter
+        {
+            private:
+                std::vector<uint8_t> *vec;
+                std::size_t           base;
+                uint8_t              *ptr;
+                std::size_t           cap;
+                std::size_t           pos;
+
+                void overflow(std::size_t arg_len);
+
+                uint8_t * claim(std::size_t arg_len)
+                {
+                    uint8_t *at;
+
+                    if (arg_len > this->cap - this->pos) this->overflow(arg_len);
+
+                    at         = this->ptr + this->pos;
+                    this->pos += arg_len;
+
+                    return at;
+                }
+
+            public:
+                ByteWriter(uint8_t *arg_ptr, std::size_t arg_cap);
+                ByteWriter(std::vector<uint8_t> &arg_vec, std::size_t arg_reserve);
+                ~ByteWriter(void);
+
+                ByteWriter(const ByteWriter &) = delete;
+                ByteWriter & operator=(const ByteWriter &) = delete;
+
+                template <unsigned W>
+                void put(uint64_t arg_val)
+                {
+                    be_store<W>::put(this->claim(W), arg_val);
+                }
+
+                void put_u8(uint8_t arg_val)   { this->put<1>(arg_val); }
+                void put_u16(uint16_t arg_val) { this->put<2>(arg_val); }
+                void put_u32(uint32_t arg_val) { this->put<4>(arg_val); }
+                void put_u48(uint64_t arg_val) { this->put<6>(arg_val); }
+                void put_u64(uint64_t arg_val) { this->put<8>(arg_val); }
+
+                void put_be(uint64_t arg_val, unsigned arg_len)
+                {
+                    be_put(this->claim(arg_len), arg_val, arg_len);
+                }
+
+                void put_bytes(const uint8_t *arg_bytes, std::size_t arg_len)
+                {
+                    memcpy(this->claim(arg_len), arg_bytes, arg_len);
+                }
+
+                void put_bytes(const std::vector<uint8_t> &arg_bytes)
+                {
+                    this->put_bytes(arg_bytes.data(), arg_bytes.size());
+                }
+
+                void put_fill(uint8_t arg_byte, std::size_t arg_len)
+                {
+                    memset(this->claim(arg_len), arg_byte, arg_len);
+                }
+
+                std::size_t size(void) const { return this->pos; }
+
+                void finish(void);
+        };
+    }
+#endif
@@ -0,0 +1,263 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <Cksum.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define CKSUM_X86 1
+#endif
+
+namespace Frames
+{
+    using namespace std;
+
+    // The ones' complement sum is byte-order independent (RFC 1071 2(B)), so
+    // the kernels add native 16/32-bit loads into a wide accumulator and the
+    // folded result is byte-swapped back to network order once at the end.
+
+    typedef uint64_t (*cksum_fn)(const uint8_t *, size_t);
+
+    static uint16_t fold(uint64_t arg_accum)
+    {
+        arg_accum = (arg_accum & 0xFFFFFFFF) + (arg_accum >> 32);
+        arg_accum = (arg_accum & 0xFFFFFFFF) + (arg_accum >> 32);
+        arg_accum = (arg_accum & 0xFFFF) + (arg_accum >> 16);
+        arg_accum = (arg_accum & 0xFFFF) + (arg_accum >> 16);
+
+        return (uint16_t)arg_accum;
+    }
+
+    static uint16_t to_net(uint16_t arg_sum)
+    {
+        #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            return (uint16_t)((arg_sum << 8) | (arg_sum >> 8));
+        #else
+            return arg_sum;
+        #endif
+    }
+
+    static uint64_t sum_tail(const uint8_t *arg_ptr, size_t arg_len)
+    {
+        uint64_t accum = 0;
+        uint32_t w32;
+        uint16_t w16;
+
+        while (arg_len >= 4)
+        {
+            memcpy(&w32, arg_ptr, 4);
+            accum   += w32;
+            arg_ptr += 4;
+            arg_len -= 4;
+        }
+
+        if (arg_len >= 2)
+        {
+            memcpy(&w16, arg_ptr, 2);
+            accum   += w16;
+            arg_ptr += 2;
+            arg_len -= 2;
+        }
+
+        if (arg_len)
+        {
+            // pad the odd byte with zero on the right, in network order
+            uint8_t pad[2] = {arg_ptr[0], 0x00};
+
+            memcpy(&w16, pad, 2);
+            accum += w16;
+        }
+
+        return accum;
+    }
+
+    static uint64_t sum_scalar(const uint8_t *arg_ptr, size_t arg_len)
+    {
+        uint64_t accum = 0;
+        uint64_t w[4];
+
+        while (arg_len >= 32)
+        {
+            memcpy(w, arg_ptr, 32);
+
+            accum += (w[0] & 0xFFFFFFFF) + (w[0] >> 32);
+            accum += (w[1] & 0xFFFFFFFF) + (w[1] >> 32);
+            accum += (w[2] & 0xFFFFFFFF) + (w[2] >> 32);
+            accum += (w[3] & 0xFFFFFFFF) + (w[3] >> 32);
+
+            arg_ptr += 32;
+            arg_len -= 32;
+        }
+
+        return accum + sum_tail(arg_ptr, arg_len);
+    }
+
+    #ifdef CKSUM_X86
+        // 32-bit lanes take at most two 16-bit words per iteration, so they are
+        // drained into the 64-bit accumulator well before they can overflow
+        const size_t CksumLaneIters = 16384;
+
+        __attribute__((target("sse2")))
+        static uint64_t sum_sse2(const uint8_t *arg_ptr, size_t arg_len)
+        {
+            const __m128i zero  = _mm_setzero_si128();
+            uint64_t      accum = 0;
+            uint32_t      lane[4];
+
+            while (arg_len >= 16)
+            {
+                __m128i lanes = zero;
+                size_t  iters = 0;
+
+                while (arg_len >= 16 and iters < CksumLaneIters)
+                {
+                    __m128i v = _mm_loadu_si128((const __m128i *)arg_ptr);
+
+                    lanes = _mm_add_epi32(lanes, _mm_unpacklo_epi16(v, zero));
+                    lanes = _mm_add_epi32(lanes, _mm_unpackhi_epi16(v, zero));
+
+                    arg_ptr += 16;
+                    arg_len -= 16;
+                    ++iters;
+                }
+
+                _mm_storeu_si128((__m128i *)lane, lanes);
+
+                for (unsigned i = 0 ; i < 4 ; ++i) accum += lane[i];
+            }
+
+            return accum + sum_tail(arg_ptr, arg_len);
+        }
+
+        __attribute__((target("avx2")))
+        static uint64_t sum_avx2(const uint8_t *arg_ptr, size_t arg_len)
+        {
+            const __m256i zero  = _mm256_setzero_si256();
+            uint64_t      accum = 0;
+            uint32_t      lane[8];
+
+            while (arg_len >= 32)
+            {
+                __m256i lanes = zero;
+                size_t  iters = 0;
+
+                while (arg_len >= 32 and iters < CksumLaneIters)
+                {
+                    __m256i v = _mm256_loadu_si256((const __m256i *)arg_ptr);
+
+                    lanes = _mm256_add_epi32(lanes, _mm256_unpacklo_epi16(v, zero));
+                    lanes = _mm256_add_epi32(lanes, _mm256_unpackhi_epi16(v, zero));
+
+                    arg_ptr += 32;
+                    arg_len -= 32;
+                    ++iters;
+                }
+
+                _mm256_storeu_si256((__m256i *)lane, lanes);
+
+                for (unsigned i = 0 ; i < 8 ; ++i) accum += lane[i];
+            }
+
+            return accum + sum_tail(arg_ptr, arg_len);
+        }
+    #endif
+
+    static cksum_fn path_fn(CksumPath arg_path)
+    {
+        #ifdef CKSUM_X86
+            if (arg_path == CksumPath::PATH_AVX2 and Cksum::has_path(arg_path)) return sum_avx2;
+            if (arg_path == CksumPath::PATH_SSE2 and Cksum::has_path(arg_path)) return sum_sse2;
+        #endif
+
+        return sum_scalar;
+    }
+
+    bool Cksum::has_path(CksumPath arg_path)
+    {
+        switch (arg_path)
+        {
+            #ifdef CKSUM_X86
+                case CksumPath::PATH_AVX2 : return __builtin_cpu_supports("avx2");
+                case CksumPath::PATH_SSE2 : return __builtin_cpu_supports("sse2");
+            #endif
+            case CksumPath::PATH_SCALAR : return true;
+            default                     : return false;
+        }
+    }
+
+    CksumPath Cksum::get_path(void)
+    {
+        // SSE2 widens each 16-bit word into a 32-bit lane, which costs more
+        // than the scalar path's 64-bit adds, so it is never picked here
+        static const CksumPath path = has_path(CksumPath::PATH_AVX2) ? CksumPath::PATH_AVX2 : CksumPath::PATH_SCALAR;
+
+        return path;
+    }
+
+    const char * Cksum::get_path_name(CksumPath arg_path)
+    {
+        switch (arg_path)
+        {
+            case CksumPath::PATH_AVX2 : return "avx2";
+            case CksumPath::PATH_SSE2 : return "sse2";
+            default                   : return "scalar";
+        }
+    }
+
+    uint16_t Cksum::sum(const uint8_t *arg_ptr, size_t arg_len, uint16_t arg_seed)
+    {
+        static const cksum_fn best = path_fn(get_path());
+
+        return to_net(fold(best(arg_ptr, arg_len) + to_net(arg_seed)));
+    }
+
+    // The original byte-at-a-time sum, kept as the reference the other
+    // paths are checked against.
+    uint16_t Cksum::sum_ref(const uint8_t *arg_ptr, size_t arg_len, uint16_t arg_seed)
+    {
+        uint32_t word  = 0;
+        uint64_t accum = arg_seed;
+        bool     mod0  = true;
+
+        for (size_t i = 0 ; i < arg_len ; ++i)
+        {
+            if (mod0)
+            {
+                word = arg_ptr[i] << 8;
+            }
+            else
+            {
+                word  = word + arg_ptr[i];
+                accum = accum + word;
+            }
+
+            mod0 = not mod0;
+        }
+
+        if (not mod0) accum = accum + word;
+
+        return fold(accum);
+    }
+
+    uint16_t Cksum::sum(CksumPath arg_path, const uint8_t *arg_ptr, size_t arg_len, uint16_t arg_seed)
+    {
+        return to_net(fold(path_fn(arg_path)(arg_ptr, arg_len) + to_net(arg_seed)));
+    }
+}
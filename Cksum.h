@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_CKSUM_H_
+    #define _FRAME_CKSUM_H_
+
+    #include <cstddef>
+    #include <cstdint>
+
+    namespace Frames
+    {
+        enum class CksumPath : uint8_t
+        {
+            PATH_SCALAR = 0x00,
+            PATH_SSE2   = 0x01,
+            PATH_AVX2   = 0x02
+        };
+
+        // Internet checksum (RFC 1071) over any buffer, length or alignment.
+        // sum() returns the folded 16-bit ones' complement sum of the buffer
+        // read as big-endian words, an odd trailing byte padded with zero, plus
+        // arg_seed (an earlier sum(), e.g. of a pseudo-header).  The checksum
+        // field value is ~sum().  The fastest path the CPU supports is picked
+        // on first use.  sum_ref() is the plain byte-wise sum, for checking.
+
+        class Cksum
+        {
+            public:
+                static uint16_t sum(const uint8_t *arg_ptr, std::size_t arg_len, uint16_t arg_seed = 0);
+                static uint16_t sum(CksumPath arg_path, const uint8_t *arg_ptr, std::size_t arg_len, uint16_t arg_seed = 0);
+                static uint16_t sum_ref(const uint8_t *arg_ptr, std::size_t arg_len, uint16_t arg_seed = 0);
+                static bool has_path(CksumPath arg_path);
+                static CksumPath get_path(void);
+                static const char * get_path_name(CksumPath arg_path);
+        };
+    }
+#endif
@@ -0,0 +1,707 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <Frame.h>
+#include <FrameEth.h>
+#include <FrameVlan.h>
+#include <FrameQinq.h>
+#include <FrameIPv4.h>
+#include <FrameUdp.h>
+#include <FrameArp.h>
+#include <FramePause.h>
+#include <FrameTemplate.h>
+#include <NicPcap.h>
+#include <PcapWriter.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define GEN_TSC 1
+#endif
+
+using namespace std;
+using namespace Frames;
+
+const BVec      gen_dmac   = {0x30,0x9c,0x23,0x1c,0x68,0x47};
+const BVec      gen_smac   = {0x40,0x6c,0x8f,0x19,0x7c,0x7d};
+const BVec      gen_dip    = {0x0a,0x00,0x00,0x02};
+const uint32_t  gen_sip    = 0x0a000001;
+const uint16_t  gen_etyp   = 0x88B5;
+const uint16_t  gen_sport  = 1024;
+const uint16_t  gen_dport  = 9;
+const unsigned  gen_svid   = 200;
+const unsigned  gen_cvid   = 100;
+const uint8_t   gen_proto  = 0xFD;
+
+const unsigned  GenBurst    = 32;
+const unsigned  GenMinBytes = 64;
+const unsigned  GenMaxBytes = 9216;
+const unsigned  GenFcsBytes = 4;
+const unsigned  GenL1Bytes  = 24;
+const uint64_t  GenSpinNs   = 50000;
+const size_t    GenMemBytes = 1 << 22;
+const uint64_t  GenDfltQty  = 1000000;
+
+// -- clock ---------------------------------------------------------------------
+// The TSC paces the fast path; it is calibrated against CLOCK_MONOTONIC once.
+
+static double tick_ns = 1.0;
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static inline uint64_t tick_now(void)
+{
+    #ifdef GEN_TSC
+        return __rdtsc();
+    #else
+        return mono_ns();
+    #endif
+}
+
+static void tick_calibrate(void)
+{
+    #ifdef GEN_TSC
+        struct timespec nap = {0, 20000000};
+        uint64_t        ns0 = mono_ns();
+        uint64_t        tk0 = tick_now();
+
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &nap, NULL);
+
+        tick_ns = (double)(tick_now() - tk0) / (double)(mono_ns() - ns0);
+    #endif
+}
+
+// Sleep through most of a long wait, then spin on the TSC for the rest, since
+// a sleep can overshoot by tens of microseconds.
+
+static void tick_wait(double arg_ns)
+{
+    uint64_t until = tick_now() + (uint64_t)(arg_ns * tick_ns);
+
+    if (arg_ns > GenSpinNs)
+    {
+        uint64_t        ns  = (uint64_t)arg_ns - GenSpinNs;
+        struct timespec nap = {(time_t)(ns / 1000000000), (long)(ns % 1000000000)};
+
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &nap, NULL);
+    }
+
+    while (tick_now() < until)
+    {
+        #ifdef GEN_TSC
+            _mm_pause();
+        #endif
+    }
+}
+
+// -- sinks ---------------------------------------------------------------------
+
+class GenSink
+{
+    public:
+        virtual ~GenSink(void) { }
+        virtual bool put(const uint8_t *arg_bytes, size_t arg_len, uint64_t arg_tick) = 0;
+        virtual bool flush(void) { return true; }
+};
+
+class GenSinkMem : public GenSink
+{
+    private:
+        BVec   mem;
+        size_t pos;
+
+    public:
+        GenSinkMem(void) : mem(GenMemBytes), pos(0) { }
+
+        virtual bool put(const uint8_t *arg_bytes, size_t arg_len, uint64_t arg_tick)
+        {
+            if (this->pos + arg_len > this->mem.size()) this->pos = 0;
+
+            memcpy(this->mem.data() + this->pos, arg_bytes, arg_len);
+            this->pos += arg_len;
+
+            return true;
+        }
+};
+
+class GenSinkPcap : public GenSink
+{
+    private:
+        PcapWriter writer;
+        uint64_t   base_ns;
+        uint64_t   base_tick;
+
+    public:
+        bool open(string arg_path)
+        {
+            struct timespec ts;
+
+            clock_gettime(CLOCK_REALTIME, &ts);
+
+            this->base_ns   = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+            this->base_tick = tick_now();
+
+            return this->writer.open(arg_path, true);
+        }
+
+        virtual bool put(const uint8_t *arg_bytes, size_t arg_len, uint64_t arg_tick)
+        {
+            uint64_t        ns = this->base_ns + (uint64_t)((arg_tick - this->base_tick) / tick_ns);
+            struct timespec ts = {(time_t)(ns / 1000000000), (long)(ns % 1000000000)};
+
+            return this->writer.write(arg_bytes, arg_len, ts);
+        }
+
+        virtual bool flush(void)
+        {
+            return this->writer.close();
+        }
+};
+
+class GenSinkNic : public GenSink
+{
+    private:
+        NicPcap     nic;
+        vector<int> results;
+
+    public:
+        bool open(string arg_name)
+        {
+            return this->nic.open(arg_name);
+        }
+
+        virtual bool put(const uint8_t *arg_bytes, size_t arg_len, uint64_t arg_tick)
+        {
+            if (not this->nic.tx_queue(arg_bytes, arg_len)) return false;
+
+            if (this->nic.tx_depth() == GenBurst) return this->flush();
+
+            return true;
+        }
+
+        virtual bool flush(void)
+        {
+            int queued = this->nic.tx_depth();
+
+            return this->nic.tx_flush(this->results) == queued;
+        }
+};
+
+// -- profile -------------------------------------------------------------------
+
+struct gen_share
+{
+    string   name;
+    unsigned weight;
+};
+
+struct gen_image
+{
+    FrameTemplate tpl;
+    unsigned      weight;
+    int           sip_id;
+    int           sport_id;
+};
+
+static bool parse_shares(const string &arg_spec, vector<gen_share> &arg_shares)
+{
+    stringstream ss(arg_spec);
+    string       tok;
+
+    arg_shares.clear();
+
+    while (getline(ss, tok, ','))
+    {
+        size_t    colon = tok.find(':');
+        gen_share share = {tok.substr(0, colon), 1};
+
+        if (colon != string::npos) share.weight = strtoul(tok.c_str() + colon + 1, NULL, 0);
+
+        if (share.name.empty() or share.weight == 0) return false;
+
+        arg_shares.push_back(share);
+    }
+
+    return not arg_shares.empty();
+}
+
+static BVec gen_payload(size_t arg_len)
+{
+    BVec bytes(arg_len);
+
+    for (size_t i = 0 ; i < arg_len ; i++) bytes[i] = (uint8_t)i;
+
+    return bytes;
+}
+
+// arg_size counts the FCS the NIC appends, as IMIX sizes do; ARP and PAUSE
+// frames keep their fixed length.
+
+static bool build_frame(const string &arg_kind, unsigned arg_size, BVec &arg_bytes)
+{
+    size_t len = arg_size - GenFcsBytes;
+
+    if (arg_kind == "eth")
+    {
+        FrameEth frame;
+
+        frame.set_eth_dmac(gen_dmac);
+        frame.set_eth_smac(gen_smac);
+        frame.set_eth_type(gen_etyp);
+        frame.set_eth_payload(gen_payload(len - 14));
+        frame.encapsulate();
+        frame.copy_frame(arg_bytes);
+    }
+    else if (arg_kind == "ipv4" or arg_kind == "udp" or arg_kind == "vlan" or arg_kind == "qinq")
+    {
+        FrameUdp frame;
+        BVec     sip;
+        size_t   hdr = 14 + IPV4_HDR_BYTES;
+
+        if (arg_kind == "qinq")
+        {
+            insert_qinq(frame, gen_svid);
+            hdr += 4;
+        }
+
+        if (arg_kind == "vlan" or arg_kind == "qinq")
+        {
+            insert_vlan(frame, gen_cvid);
+            hdr += 4;
+        }
+
+        Frame::to_bvec(sip, gen_sip);
+
+        frame.set_eth_dmac(gen_dmac);
+        frame.set_eth_smac(gen_smac);
+        frame.set_ipv4_sip(sip);
+        frame.set_ipv4_dip(gen_dip);
+
+        if (arg_kind == "ipv4")
+        {
+            frame.set_ipv4_proto((IPv4Proto)gen_proto);
+            frame.set_ipv4_payload(gen_payload(len - hdr));
+            frame.FrameIPv4::encapsulate();
+        }
+        else
+        {
+            frame.set_udp_sport(gen_sport);
+            frame.set_udp_dport(gen_dport);
+            frame.set_udp_payload(gen_payload(len - hdr - UDP_HDR_BYTES));
+            frame.encapsulate();
+        }
+
+        frame.copy_frame(arg_bytes);
+    }
+    else if (arg_kind == "arp")
+    {
+        FrameArp frame;
+        BVec     sip;
+
+        Frame::to_bvec(sip, gen_sip);
+
+        frame.set_arp_op(ArpOp::OP_REQ);
+        frame.set_arp_qmac(gen_smac);
+        frame.set_arp_qip(sip);
+        frame.set_arp_tmac(gen_dmac);
+        frame.set_arp_tip(gen_dip);
+        frame.encapsulate();
+        frame.copy_frame(arg_bytes);
+    }
+    else if (arg_kind == "pause")
+    {
+        FramePause frame;
+
+        frame.set_eth_smac(gen_smac);
+        frame.set_pause_param(0xFFFF);
+        frame.encapsulate();
+        frame.copy_frame(arg_bytes);
+    }
+    else
+    {
+        cerr << "EthGen: unknown frame kind " << arg_kind << endl << flush;
+        return false;
+    }
+
+    return true;
+}
+
+static bool build_images(const vector<gen_share> &arg_kinds, const vector<gen_share> &arg_sizes, vector<gen_image> &arg_images)
+{
+    for (const gen_share &kind : arg_kinds)
+    {
+        for (const gen_share &size : arg_sizes)
+        {
+            unsigned  bytes = strtoul(size.name.c_str(), NULL, 0);
+            gen_image image;
+            BVec      frame;
+
+            if (bytes < GenMinBytes or bytes > GenMaxBytes)
+            {
+                cerr << "EthGen: frame size " << size.name << " is outside " << GenMinBytes << " to " << GenMaxBytes << endl << flush;
+                return false;
+            }
+
+            if (not build_frame(kind.name, bytes, frame)) return false;
+            if (not image.tpl.capture(frame.data(), frame.size())) return false;
+
+            image.weight   = kind.weight * size.weight;
+            image.sip_id   = image.tpl.find_patch("ipv4.sip");
+            image.sport_id = image.tpl.find_patch("udp.sport");
+
+            arg_images.push_back(image);
+        }
+    }
+
+    return true;
+}
+
+// Smooth weighted round-robin: each image appears weight times per cycle,
+// spread out rather than in runs, so a size mix does not arrive in bursts.
+
+static void build_schedule(const vector<gen_image> &arg_images, vector<unsigned> &arg_sched)
+{
+    vector<long> credit(arg_images.size(), 0);
+    long         total = 0;
+
+    for (const gen_image &image : arg_images) total += image.weight;
+
+    for (long n = 0 ; n < total ; n++)
+    {
+        unsigned best = 0;
+
+        for (unsigned i = 0 ; i < arg_images.size() ; i++)
+        {
+            credit[i] += arg_images[i].weight;
+
+            if (credit[i] > credit[best]) best = i;
+        }
+
+        credit[best] -= total;
+        arg_sched.push_back(best);
+    }
+}
+
+// -- threads -------------------------------------------------------------------
+
+struct gen_thread
+{
+    unsigned          index;
+    int               cpu;
+    vector<gen_image> images;
+    vector<unsigned>  sched;
+    unsigned          flows;
+    uint64_t          quota;
+    uint64_t          end_tick;
+    double            rate;
+    GenSink          *sink;
+    bool              okay;
+    uint64_t          frames;
+    uint64_t          bytes;
+    double            secs;
+};
+
+static void gen_pin(int arg_cpu)
+{
+    cpu_set_t set;
+
+    if (arg_cpu < 0) return;
+
+    CPU_ZERO(&set);
+    CPU_SET(arg_cpu, &set);
+
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    {
+        cerr << "EthGen: cannot pin thread to cpu " << arg_cpu << endl << flush;
+    }
+}
+
+static void gen_run(gen_thread &arg_gt)
+{
+    vector<uint8_t> buf(GenMaxBytes);
+    double          per_tick = arg_gt.rate / (tick_ns * 1e9);
+    double          tokens   = 0;
+    size_t          pos      = 0;
+    uint64_t        start;
+    uint64_t        last;
+    uint64_t        now;
+
+    gen_pin(arg_gt.cpu);
+
+    start = last = tick_now();
+
+    while (arg_gt.okay)
+    {
+        unsigned n = GenBurst;
+
+        if (arg_gt.rate > 0)
+        {
+            now     = tick_now();
+            tokens += (now - last) * per_tick;
+            last    = now;
+
+            if (tokens > GenBurst) tokens = GenBurst;
+
+            if (tokens < 1.0)
+            {
+                tick_wait((1.0 - tokens) / arg_gt.rate * 1e9);
+                continue;
+            }
+
+            n = (unsigned)tokens;
+        }
+
+        if (arg_gt.quota and n > arg_gt.quota - arg_gt.frames) n = arg_gt.quota - arg_gt.frames;
+
+        now = tick_now();
+
+        for (unsigned i = 0 ; i < n ; i++)
+        {
+            gen_image     &image = arg_gt.images[arg_gt.sched[pos]];
+            const uint8_t *bytes = image.tpl.peek_image().data();
+            size_t         len   = image.tpl.size();
+
+            if (++pos == arg_gt.sched.size()) pos = 0;
+
+            if (arg_gt.flows > 1 and image.sip_id >= 0)
+            {
+                unsigned flow = arg_gt.frames % arg_gt.flows;
+
+                image.tpl.stamp(buf.data());
+                image.tpl.patch(buf.data(), image.sip_id, gen_sip + flow);
+
+                if (image.sport_id >= 0) image.tpl.patch(buf.data(), image.sport_id, gen_sport + flow);
+
+                bytes = buf.data();
+            }
+
+            if (not arg_gt.sink->put(bytes, len, now))
+            {
+                arg_gt.okay = false;
+                break;
+            }
+
+            arg_gt.frames += 1;
+            arg_gt.bytes  += len;
+        }
+
+        tokens -= n;
+
+        if (arg_gt.quota and arg_gt.frames >= arg_gt.quota) break;
+        if (arg_gt.end_tick and tick_now() >= arg_gt.end_tick) break;
+    }
+
+    if (not arg_gt.sink->flush()) arg_gt.okay = false;
+
+    arg_gt.secs = (tick_now() - start) / tick_ns / 1e9;
+}
+
+// -- main ----------------------------------------------------------------------
+
+static double parse_rate(const char *arg_str)
+{
+    char  *end;
+    double val = strtod(arg_str, &end);
+
+    switch (*end)
+    {
+        case 'k' : case 'K' : val *= 1e3; break;
+        case 'm' : case 'M' : val *= 1e6; break;
+        case 'g' : case 'G' : val *= 1e9; break;
+        default             : break;
+    }
+
+    return val;
+}
+
+static void usage(void)
+{
+    cerr << "usage: EthGen [-o sink] [-p profile] [-s sizes] [-r pps] [-n frames] [-d secs] [-t threads] [-c cpu] [-f flows]" << endl
+         << "  -o  mem (default), pcap:<path> (one file per thread, .N appended) or nic:<device>" << endl
+         << "  -p  kind[:weight],...  kinds eth, vlan, qinq, ipv4, udp, arp, pause (default udp)" << endl
+         << "      vlan and qinq are UDP frames under one or two tags" << endl
+         << "  -s  size[:weight],... in bytes with FCS, or imix for 64:7,594:4,1518:1 (default 64)" << endl
+         << "  -r  total frames per second, k/M/G suffixes, 0 for unpaced (default 0)" << endl
+         << "  -n  total frames (default " << GenDfltQty << " unless -d is given)" << endl
+         << "  -d  run time in seconds" << endl
+         << "  -t  tx threads, one per core (default 1)" << endl
+         << "  -c  first cpu to pin threads to, -1 for none (default -1)" << endl
+         << "  -f  IPv4 flows, varying source address and port (default 1)" << endl << flush;
+}
+
+int main(int argc, char **argv)
+{
+    string             sink_spec = "mem";
+    string             kind_spec = "udp";
+    string             size_spec = "64";
+    double             rate      = 0;
+    uint64_t           quota     = 0;
+    double             secs      = 0;
+    unsigned           threads   = 1;
+    int                cpu       = -1;
+    unsigned           flows     = 1;
+    vector<gen_share>  kinds;
+    vector<gen_share>  sizes;
+    vector<gen_image>  images;
+    vector<unsigned>   sched;
+    vector<gen_thread> gts;
+    vector<thread>     runs;
+    uint64_t           frames    = 0;
+    uint64_t           bytes     = 0;
+    double             elapsed   = 0;
+    double             per_sec;
+    bool               okay      = true;
+    int                opt;
+
+    while ((opt = getopt(argc, argv, "o:p:s:r:n:d:t:c:f:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o' : sink_spec = optarg;                   break;
+            case 'p' : kind_spec = optarg;                   break;
+            case 's' : size_spec = optarg;                   break;
+            case 'r' : rate      = parse_rate(optarg);       break;
+            case 'n' : quota     = strtoull(optarg, NULL, 0); break;
+            case 'd' : secs      = strtod(optarg, NULL);     break;
+            case 't' : threads   = strtoul(optarg, NULL, 0); break;
+            case 'c' : cpu       = strtol(optarg, NULL, 0);  break;
+            case 'f' : flows     = strtoul(optarg, NULL, 0); break;
+            default  : usage(); exit(1);
+        }
+    }
+
+    if (size_spec == "imix") size_spec = "64:7,594:4,1518:1";
+
+    if (not parse_shares(kind_spec, kinds) or not parse_shares(size_spec, sizes) or threads == 0)
+    {
+        usage();
+        exit(1);
+    }
+
+    if (quota == 0 and secs <= 0) quota = GenDfltQty;
+
+    // a quota of 0 means no limit, so every thread needs at least one frame
+    if (quota > 0 and threads > quota) threads = quota;
+
+    if (not build_images(kinds, sizes, images)) exit(1);
+
+    build_schedule(images, sched);
+    tick_calibrate();
+
+    gts.resize(threads);
+
+    for (unsigned i = 0 ; i < threads ; i++)
+    {
+        gen_thread &gt = gts[i];
+
+        gt.index    = i;
+        gt.cpu      = (cpu < 0) ? -1 : cpu + (int)i;
+        gt.images   = images;
+        gt.sched    = sched;
+        gt.flows    = flows;
+        gt.quota    = quota / threads + ((i < quota % threads) ? 1 : 0);
+        gt.end_tick = (secs > 0) ? tick_now() + (uint64_t)(secs * 1e9 * tick_ns) : 0;
+        gt.rate     = rate / threads;
+        gt.okay     = true;
+        gt.frames   = 0;
+        gt.bytes    = 0;
+        gt.secs     = 0;
+
+        if (sink_spec == "mem")
+        {
+            gt.sink = new GenSinkMem();
+        }
+        else if (sink_spec.compare(0, 5, "pcap:") == 0)
+        {
+            GenSinkPcap *sink = new GenSinkPcap();
+            string       path = sink_spec.substr(5);
+
+            if (threads > 1) path += "." + to_string(i);
+
+            gt.sink = sink;
+
+            if (not sink->open(path)) exit(1);
+        }
+        else if (sink_spec.compare(0, 4, "nic:") == 0)
+        {
+            GenSinkNic *sink = new GenSinkNic();
+
+            gt.sink = sink;
+
+            if (not sink->open(sink_spec.substr(4))) exit(1);
+        }
+        else
+        {
+            usage();
+            exit(1);
+        }
+    }
+
+    for (gen_thread &gt : gts) runs.push_back(thread(gen_run, ref(gt)));
+    for (thread &run : runs)   run.join();
+
+    cout << fixed;
+
+    for (gen_thread &gt : gts)
+    {
+        if (not gt.okay)
+        {
+            cerr << "EthGen: thread " << gt.index << " sink failure" << endl << flush;
+            okay = false;
+        }
+
+        cout << "EthGen: thread " << gt.index << " cpu " << gt.cpu << " frames " << gt.frames << " bytes " << gt.bytes
+             << " secs " << setprecision(3) << gt.secs << " pps " << setprecision(0) << (gt.secs > 0 ? gt.frames / gt.secs : 0) << endl;
+
+        frames  += gt.frames;
+        bytes   += gt.bytes;
+        elapsed  = max(elapsed, gt.secs);
+
+        delete gt.sink;
+    }
+
+    // a run too short to time reports zero rates rather than dividing by zero
+    per_sec = (elapsed > 0) ? 1.0 / elapsed : 0.0;
+
+    cout << "EthGen: total frames " << frames << " bytes " << bytes << " secs " << setprecision(3) << elapsed
+         << setprecision(0)
+         << " pps "    << frames * per_sec
+         << " bps "    << bytes * 8 * per_sec
+         << " l1_bps " << (bytes + frames * GenL1Bytes) * 8 * per_sec << endl << flush;
+
+    exit(okay ? 0 : 1);
+}
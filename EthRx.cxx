@@ -28,11 +28,12 @@ using namespace std;
 using namespace Frames;
 
 const string SP       = "\x20";
-const string nic_name = "enx309c231c6847";
+const string nic_dflt = "enx309c231c6847";
 
 int main(int argc, char **argv)
 {
     FrameEth *rx_frame = new FrameEth();
+    string    nic_name = (argc > 1) ? argv[1] : nic_dflt;
     bool      nic_ret;
 
     nic_ret = rx_frame->nic_open(nic_name);
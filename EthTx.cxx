@@ -28,7 +28,7 @@ using namespace std;
 using namespace Frames;
 
 const string    SP       = "\x20";
-const string    nic_name = "enx406c8f197c7d";
+const string    nic_dflt = "enx406c8f197c7d";
 const BVec      tx_dmac  = {0x30,0x9c,0x23,0x1c,0x68,0x47}; // enx309c231c6847
 const BVec      tx_smac  = {0x40,0x6c,0x8f,0x19,0x7c,0x7d}; // enx406c8f197c7d
 const uint16_t  tx_etyp  = 0x1005;
@@ -42,6 +42,7 @@ const BVec      tx_pyld  = {
 int main(int argc, char **argv)
 {
     FrameEth *tx_frame = new FrameEth();
+    string    nic_name = (argc > 1) ? argv[1] : nic_dflt;
     bool      nic_ret;
 
     cerr << "-- Start ------------------------" << endl << flush;
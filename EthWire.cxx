@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <Frame.h>
+#include <FrameEth.h>
+#include <NicWire.h>
+
+using namespace std;
+using namespace Frames;
+
+const BVec      tx_dmac  = {0x30,0x9c,0x23,0x1c,0x68,0x47};
+const BVec      tx_smac  = {0x40,0x6c,0x8f,0x19,0x7c,0x7d};
+const uint16_t  tx_etyp  = 0x1005;
+const BVec      tx_pyld  = {
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x01, 0xF9, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x08
+  };
+
+int main(int argc, char **argv)
+{
+    WirePair  wire;
+    FrameEth *tx_frame = new FrameEth();
+    FrameEth *rx_frame = new FrameEth();
+    BVec      tx_bytes;
+    BVec      rx_bytes;
+
+    tx_frame->nic_attach(wire.end_a());
+    rx_frame->nic_attach(wire.end_b());
+
+    tx_frame->set_eth_dmac(tx_dmac);
+    tx_frame->set_eth_smac(tx_smac);
+    tx_frame->set_eth_type(tx_etyp);
+    tx_frame->set_eth_payload(tx_pyld);
+    tx_frame->encapsulate();
+    tx_frame->copy_frame(tx_bytes);
+
+    if (not tx_frame->nic_tx_frame())
+    {
+        cerr << "EthWire: nic_tx_frame() failure" << endl << flush;
+        exit(1);
+    }
+
+    if (not rx_frame->nic_rx_frame())
+    {
+        cerr << "EthWire: nic_rx_frame() failure" << endl << flush;
+        exit(1);
+    }
+
+    rx_frame->copy_frame(rx_bytes);
+
+    cerr << "FrameEth:"+rx_frame->gist() << endl << flush;
+
+    if (rx_bytes != tx_bytes)
+    {
+        cerr << "EthWire: received frame differs from transmitted frame" << endl << flush;
+        exit(1);
+    }
+
+    tx_frame->nic_close();
+    rx_frame->nic_close();
+
+    exit(0);
+}
@@ -0,0 +1,316 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <FrameEth.h>
+#include <FrameIPv4.h>
+#include <FlowHash.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define FLOW_X86 1
+#endif
+
+namespace Frames
+{
+    using namespace std;
+
+    const uint8_t FlowKeyRss[FlowKeyBytes] =
+    {
+        0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+        0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+        0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+        0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+        0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa
+    };
+
+    const unsigned FlowBatchLanes = 8;
+
+    // the 32 key bits starting at bit arg_bit, most significant bit first
+    static uint32_t key_window(const uint8_t *arg_key, unsigned arg_bit)
+    {
+        const uint8_t *p = arg_key + (arg_bit / 8);
+        uint64_t       w = 0;
+
+        for (unsigned i = 0 ; i < 5 ; ++i) w = (w << 8) | p[i];
+
+        return (uint32_t)(w >> (8 - (arg_bit % 8)));
+    }
+
+    FlowHash::FlowHash(FlowMode arg_mode)
+    {
+        if (arg_mode == FlowMode::MODE_SYMMETRIC)
+        {
+            for (unsigned i = 0 ; i < FlowKeyBytes ; i += 2)
+            {
+                this->key[i + 0] = 0x6d;
+                this->key[i + 1] = 0x5a;
+            }
+        }
+        else
+        {
+            memcpy(this->key, FlowKeyRss, FlowKeyBytes);
+        }
+
+        this->build_table();
+    }
+
+    void FlowHash::build_table(void)
+    {
+        for (unsigned pos = 0 ; pos < FlowInputBytes ; ++pos)
+        {
+            for (unsigned val = 0 ; val < 256 ; ++val)
+            {
+                uint32_t h = 0;
+
+                for (unsigned bit = 0 ; bit < 8 ; ++bit)
+                {
+                    if (val & (0x80 >> bit)) h ^= key_window(this->key, pos * 8 + bit);
+                }
+
+                this->table[pos][val] = h;
+            }
+        }
+    }
+
+    bool FlowHash::set_key(const uint8_t *arg_key, size_t arg_len)
+    {
+        if (arg_len != FlowKeyBytes)
+        {
+            cerr << "FlowHash::set_key(): key must be " << FlowKeyBytes << " bytes" << endl << flush;
+            return false;
+        }
+
+        memcpy(this->key, arg_key, FlowKeyBytes);
+        this->build_table();
+
+        return true;
+    }
+
+    const uint8_t * FlowHash::get_key(void) const
+    {
+        return this->key;
+    }
+
+    bool FlowHash::extract(const uint8_t *arg_ptr, size_t arg_len, flow_key &arg_key)
+    {
+        const uint8_t *ip;
+        unsigned       off = 12;
+        unsigned       hlen;
+        uint16_t       type;
+
+        memset(&arg_key, 0, sizeof(arg_key));
+
+        if (arg_len < 14) return false;
+
+        type = be_load<2>::get(arg_ptr + off);
+
+        while (type == (uint16_t)EtherType::ETYP_VLAN or type == (uint16_t)EtherType::ETYP_QINQ)
+        {
+            if (off + 6 > arg_len) break;
+
+            if (off == 12) arg_key.vid = be_load<2>::get(arg_ptr + off + 2) & 0x0FFF;
+
+            off  += 4;
+            type  = be_load<2>::get(arg_ptr + off);
+        }
+
+        ip = arg_ptr + off + 2;
+
+        if (type == (uint16_t)EtherType::ETYP_IPV4 and off + 2 + IPV4_HDR_BYTES <= arg_len and (ip[0] >> 4) == IPV4_VERS)
+        {
+            hlen = (ip[0] & 0x0F) * 4;
+
+            if (hlen >= IPV4_HDR_BYTES and off + 2 + hlen <= arg_len)
+            {
+                arg_key.kind  = FlowKindIPv4;
+                arg_key.proto = ip[9];
+                memcpy(arg_key.input, ip + 12, 8);
+
+                // ports only for unfragmented datagrams, so all fragments of one
+                // datagram land on the same worker
+                if ((be_load<2>::get(ip + 6) & 0x3FFF) == 0 and off + 2 + hlen + 4 <= arg_len)
+                {
+                    if (arg_key.proto == (uint8_t)IPv4Proto::PROTO_UDP or arg_key.proto == (uint8_t)IPv4Proto::PROTO_TCP)
+                    {
+                        arg_key.kind = FlowKindIPv4L4;
+                        memcpy(arg_key.input + 8, ip + hlen, 4);
+                    }
+                }
+
+                return true;
+            }
+        }
+
+        arg_key.kind = FlowKindL2;
+        memcpy(arg_key.input, arg_ptr, 12);
+
+        return true;
+    }
+
+    // Multiply-shift maps a 32-bit hash onto arg_count workers without a
+    // division and uses the high hash bits, which the low ones need not mix.
+
+    unsigned FlowHash::pick(uint32_t arg_hash, unsigned arg_count)
+    {
+        return (unsigned)(((uint64_t)arg_hash * arg_count) >> 32);
+    }
+
+    bool FlowHash::has_path(FlowPath arg_path)
+    {
+        switch (arg_path)
+        {
+            #ifdef FLOW_X86
+                case FlowPath::PATH_AVX2   : return __builtin_cpu_supports("avx2");
+            #endif
+            case FlowPath::PATH_SCALAR : return true;
+            default                    : return false;
+        }
+    }
+
+    uint32_t FlowHash::hash(const flow_key &arg_key) const
+    {
+        uint32_t h = 0;
+
+        for (unsigned i = 0 ; i < FlowInputBytes ; ++i) h ^= this->table[i][arg_key.input[i]];
+
+        return h;
+    }
+
+    uint32_t FlowHash::hash(const uint8_t *arg_ptr, size_t arg_len) const
+    {
+        flow_key fk;
+
+        extract(arg_ptr, arg_len, fk);
+
+        return this->hash(fk);
+    }
+
+    // Bitwise reference over any input the key covers, e.g. an IPv6 tuple.
+
+    uint32_t FlowHash::hash_input(const uint8_t *arg_input, size_t arg_len) const
+    {
+        uint32_t h = 0;
+
+        if (arg_len > FlowKeyBytes - 4)
+        {
+            cerr << "FlowHash::hash_input(): input longer than " << FlowKeyBytes - 4 << " bytes" << endl << flush;
+            return 0;
+        }
+
+        for (unsigned bit = 0 ; bit < arg_len * 8 ; ++bit)
+        {
+            if (arg_input[bit / 8] & (0x80 >> (bit % 8))) h ^= key_window(this->key, bit);
+        }
+
+        return h;
+    }
+
+    #ifdef FLOW_X86
+        // Eight keys per step: their input words are gathered into lanes, then
+        // each input byte indexes its row of the table through a second gather.
+
+        __attribute__((target("avx2")))
+        static unsigned hash_avx2(const uint32_t (*arg_table)[256], const flow_key *arg_keys, unsigned arg_count, uint32_t *arg_hashes)
+        {
+            const int     stride = sizeof(flow_key);
+            const __m256i lanes  = _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+            const __m256i mask   = _mm256_set1_epi32(0xFF);
+            const int    *rows   = (const int *)arg_table;
+            unsigned      done   = 0;
+
+            while (arg_count - done >= FlowBatchLanes)
+            {
+                const int *base = (const int *)arg_keys[done].input;
+                __m256i    h    = _mm256_setzero_si256();
+
+                for (unsigned w = 0 ; w < FlowInputBytes / 4 ; ++w)
+                {
+                    __m256i words = _mm256_i32gather_epi32(base + w, lanes, 1);
+
+                    for (unsigned b = 0 ; b < 4 ; ++b)
+                    {
+                        // little-endian lanes: byte b of the word is input byte 4w+b
+                        __m256i val = _mm256_and_si256(_mm256_srli_epi32(words, 8 * b), mask);
+                        __m256i idx = _mm256_add_epi32(val, _mm256_set1_epi32((4 * w + b) * 256));
+
+                        h = _mm256_xor_si256(h, _mm256_i32gather_epi32(rows, idx, 4));
+                    }
+                }
+
+                _mm256_storeu_si256((__m256i *)(arg_hashes + done), h);
+                done += FlowBatchLanes;
+            }
+
+            return done;
+        }
+    #endif
+
+    void FlowHash::hash_batch(FlowPath arg_path, const flow_key *arg_keys, unsigned arg_count, uint32_t *arg_hashes) const
+    {
+        unsigned done = 0;
+
+        #ifdef FLOW_X86
+            #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                if (arg_path == FlowPath::PATH_AVX2 and has_path(arg_path))
+                {
+                    done = hash_avx2(this->table, arg_keys, arg_count, arg_hashes);
+                }
+            #endif
+        #endif
+
+        for (unsigned i = done ; i < arg_count ; ++i) arg_hashes[i] = this->hash(arg_keys[i]);
+    }
+
+    void FlowHash::hash_batch(const flow_key *arg_keys, unsigned arg_count, uint32_t *arg_hashes) const
+    {
+        static const FlowPath best = has_path(FlowPath::PATH_AVX2) ? FlowPath::PATH_AVX2 : FlowPath::PATH_SCALAR;
+
+        this->hash_batch(best, arg_keys, arg_count, arg_hashes);
+    }
+
+    // Keys are extracted first, prefetching the next frame as decode_batch()
+    // does, then hashed together.
+
+    void FlowHash::hash_batch(const FrameView *arg_views, unsigned arg_count, flow_key *arg_keys, uint32_t *arg_hashes) const
+    {
+        for (unsigned i = 0 ; i < arg_count ; ++i)
+        {
+            if (i + 1 < arg_count) __builtin_prefetch(arg_views[i + 1].data);
+
+            extract(arg_views[i].data, arg_views[i].caplen, arg_keys[i]);
+        }
+
+        this->hash_batch(arg_keys, arg_count, arg_hashes);
+    }
+
+    void FlowHash::hash_batch(const struct rx_burst &arg_burst, flow_key *arg_keys, uint32_t *arg_hashes) const
+    {
+        for (unsigned i = 0 ; i < arg_burst.count ; ++i)
+        {
+            if (i + 1 < arg_burst.count) __builtin_prefetch(arg_burst.slots[i + 1].bytes.data());
+
+            extract(arg_burst.slots[i].bytes.data(), arg_burst.slots[i].bytes.size(), arg_keys[i]);
+        }
+
+        this->hash_batch(arg_keys, arg_burst.count, arg_hashes);
+    }
+}
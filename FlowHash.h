@@ -0,0 +1,95 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_FLOW_HASH_H_
+    #define _FRAME_FLOW_HASH_H_
+
+    #include <Frame.h>
+
+    namespace Frames
+    {
+        const unsigned FlowKeyBytes   = 40;
+        const unsigned FlowInputBytes = 12;
+
+        const uint8_t  FlowKindL2     = 0x00;
+        const uint8_t  FlowKindIPv4   = 0x01;
+        const uint8_t  FlowKindIPv4L4 = 0x02;
+
+        enum class FlowMode : uint8_t
+        {
+            MODE_RSS       = 0x00,
+            MODE_SYMMETRIC = 0x01
+        };
+
+        enum class FlowPath : uint8_t
+        {
+            PATH_SCALAR = 0x00,
+            PATH_AVX2   = 0x01
+        };
+
+        // Hash input in RSS order, network byte order: sip, dip, sport, dport
+        // for TCP/UDP over unfragmented IPv4, sip, dip for other IPv4, dmac,
+        // smac for anything else.  Unused input bytes are zero, which leave a
+        // Toeplitz hash unchanged, so every kind hashes as FlowInputBytes.
+        // vid is the outermost tag's VLAN id (0 if untagged) and is not hashed.
+        struct flow_key
+        {
+            uint8_t  input[16];
+            uint8_t  kind;
+            uint8_t  proto;
+            uint16_t vid;
+        };
+
+        // Toeplitz hash, table-driven: one 32-bit table entry per input byte
+        // position and value.  MODE_RSS uses the common Microsoft RSS key, so
+        // hashes match what a NIC computes; MODE_SYMMETRIC uses a key that
+        // repeats 0x6d5a, which gives the same hash for both directions of a
+        // flow, at the cost of repeating its upper 16 bits in the lower 16;
+        // flows whose address and port step together also collide with it.
+        // set_key() loads any other 40-byte key.
+
+        class FlowHash
+        {
+            private:
+                uint8_t  key[FlowKeyBytes];
+                uint32_t table[FlowInputBytes][256];
+
+                void build_table(void);
+
+            public:
+                FlowHash(FlowMode arg_mode = FlowMode::MODE_RSS);
+
+                bool set_key(const uint8_t *arg_key, std::size_t arg_len);
+                const uint8_t * get_key(void) const;
+
+                static bool extract(const uint8_t *arg_ptr, std::size_t arg_len, flow_key &arg_key);
+                static unsigned pick(uint32_t arg_hash, unsigned arg_count);
+                static bool has_path(FlowPath arg_path);
+
+                uint32_t hash(const flow_key &arg_key) const;
+                uint32_t hash(const uint8_t *arg_ptr, std::size_t arg_len) const;
+                uint32_t hash_input(const uint8_t *arg_input, std::size_t arg_len) const;
+
+                void hash_batch(const flow_key *arg_keys, unsigned arg_count, uint32_t *arg_hashes) const;
+                void hash_batch(FlowPath arg_path, const flow_key *arg_keys, unsigned arg_count, uint32_t *arg_hashes) const;
+                void hash_batch(const FrameView *arg_views, unsigned arg_count, flow_key *arg_keys, uint32_t *arg_hashes) const;
+                void hash_batch(const struct rx_burst &arg_burst, flow_key *arg_keys, uint32_t *arg_hashes) const;
+        };
+    }
+#endif
@@ -18,9 +18,14 @@
  */
 
 #include <Frame.h>
+#include <BufPool.h>
+#include <ByteWriter.h>
+#include <FrameFmt.h>
+#include <Nic.h>
+#include <NicPcap.h>
+#include <NicPcapFile.h>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
 #include <utility>
 #include <cstring>
 #include <string>
@@ -29,6 +34,54 @@ namespace Frames
 {
     using namespace std;
 
+    void field::set(const uint8_t *arg_bytes, unsigned arg_len)
+    {
+        this->size  = 0;
+        this->valid = false;
+
+        this->append(arg_bytes, arg_len);
+    }
+
+    void field::append(const uint8_t *arg_bytes, unsigned arg_len)
+    {
+        if (this->size + arg_len > FieldMaxBytes)
+        {
+            cerr << "[ERR] field::append(): field cannot hold more than " << FieldMaxBytes << " bytes" << endl << flush;
+            exit(1);
+        }
+
+        memcpy(this->bytes + this->size, arg_bytes, arg_len);
+
+        this->size += arg_len;
+        this->valid = true;
+    }
+
+    void field::clear(void)
+    {
+        this->size  = 0;
+        this->valid = false;
+    }
+
+    rx_burst::rx_burst(unsigned arg_slots, unsigned arg_reserve)
+    {
+        this->count = 0;
+        this->reserve(arg_slots, arg_reserve);
+    }
+
+    void rx_burst::reserve(unsigned arg_slots, unsigned arg_reserve)
+    {
+        unsigned have = this->slots.size();
+
+        if (arg_slots <= have) return;
+
+        this->slots.resize(arg_slots);
+
+        for (unsigned i = have ; i < arg_slots ; i++)
+        {
+            this->slots[i].bytes.reserve(arg_reserve);
+        }
+    }
+
     Frame::Frame(void)
     {
         this->iter_idle   = true;
@@ -40,11 +93,18 @@ namespace Frames
 
     void Frame::give_frame(BVec &&arg_bytes)
     {
-        this->frame.bytes = arg_bytes;
+        this->frame.bytes = move(arg_bytes);
         this->frame.valid = true;
         arg_bytes         = BVec();
     }
 
+    void Frame::load_frame(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        this->frame.bytes.assign(arg_bytes, arg_bytes + arg_len);
+        this->frame.valid = true;
+        this->iter_idle   = true;
+    }
+
     void Frame::copy_frame(BVec &arg_bytes)
     {
         arg_bytes.clear();
@@ -63,24 +123,27 @@ namespace Frames
         this->frame.bytes.clear();
     }
 
+    const BVec & Frame::peek_frame(void)
+    {
+        return this->frame.bytes;
+    }
+
+    FrameCursor Frame::cursor_frame(void)
+    {
+        return FrameCursor(this->frame.bytes);
+    }
+
+    Buf Frame::share_frame(void)
+    {
+        return Buf(this->frame.bytes.data(), this->frame.bytes.size());
+    }
+
     BVec & Frame::to_bvec(BVec & arg_bvec, const uint64_t arg_uint, const unsigned int arg_len)
     {
-        for (unsigned int i = 0 ; i < 8 ; i++)
-        {
-            if ((8-i) > arg_len) continue;
-
-            switch (i)
-            {
-                case 0 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x38) & 0xff)); break;
-                case 1 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x30) & 0xff)); break;
-                case 2 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x28) & 0xff)); break;
-                case 3 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x20) & 0xff)); break;
-                case 4 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x18) & 0xff)); break;
-                case 5 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x10) & 0xff)); break;
-                case 6 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x08) & 0xff)); break;
-                case 7 : arg_bvec.push_back((uint8_t)((arg_uint >> 0x00) & 0xff)); break;
-            }
-        }
+        unsigned int len = (arg_len > 8) ? 8 : arg_len;
+        ByteWriter   bw(arg_bvec, len);
+
+        bw.put_be(arg_uint, len);
 
         return arg_bvec;
     }
@@ -109,143 +172,129 @@ namespace Frames
         return to_bvec(arg_bvec, tmp_uint, tmp_len);
     }
 
+    bool Frame::nic_ready(const char *arg_who)
+    {
+        if (this->nic) return true;
+
+        cerr << "Frame::" << arg_who << "(): no nic is open" << endl << flush;
+        return false;
+    }
+
     bool Frame::nic_open(std::string arg_nic_name)
     {
-        #ifndef PCAP_DISABLE
-            this->nic_errbuf[0] = '\0';
-            this->nic_handle    = pcap_open_live(arg_nic_name.c_str(), 65536, 0, 100, this->nic_errbuf);
+        this->nic = make_shared<NicPcap>();
 
-            if (this->nic_handle == NULL)
-            {
-                cerr << "Frame::nic_open(): failure opening device " << this->nic_errbuf << endl << flush;
-                return false;
-            }
+        return this->nic->open(arg_nic_name);
+    }
 
-            if (strlen(this->nic_errbuf) != 0)
-            {
-                cerr << "Frame::nic_open(): warning opening device " << this->nic_errbuf << endl << flush;
-                return false;
-            }
+    bool Frame::nic_open_offline(std::string arg_path, bool arg_nano)
+    {
+        this->nic = make_shared<NicPcapFile>(arg_nano);
 
-            if (false)
-            {
-                cerr << "Frame::nic_open(): okay" << endl << flush;
-            }
-        #endif
+        return this->nic->open(arg_path);
+    }
+
+    bool Frame::nic_attach(Nic &arg_nic)
+    {
+        this->nic = shared_ptr<Nic>(&arg_nic, [](Nic *arg_ptr) { });
 
         return true;
     }
 
     void Frame::nic_close(void)
     {
-        #ifndef PCAP_DISABLE
-            pcap_close(this->nic_handle);
-        #endif
+        if (this->nic)
+        {
+            this->nic->close();
+        }
+
+        this->nic.reset();
     }
 
     bool Frame::nic_rx_filter(string arg_expr)
     {
-        int      ret;
+        if (not this->nic_ready("nic_rx_filter")) return false;
 
-        #ifndef PCAP_DISABLE
-            ret = pcap_compile(this->nic_handle, &this->nic_bpf,arg_expr. c_str(), 0, PCAP_NETMASK_UNKNOWN);
+        return this->nic->rx_filter(arg_expr);
+    }
 
-            if (ret < 0)
-            {
-                pcap_perror(this->nic_handle, "Frame::nic_rx_filter(): pcap_compile failure");
-                return false;
-            }
+    bool Frame::nic_rx_frame(void)
+    {
+        if (not this->nic_ready("nic_rx_frame")) return false;
 
-            ret = pcap_setfilter(this->nic_handle, &this->nic_bpf);
+        if (not this->nic->rx_frame(this->frame.bytes)) return false;
 
-            if (ret < 0)
-            {
-                pcap_perror(this->nic_handle, "Frame::nic_rx_filter(): pcap_setfilter failure");
-                return false;
-            }
-        #endif
+        this->frame.valid = true;
+        this->iter_idle   = true;
 
         return true;
     }
 
-    bool Frame::nic_rx_frame(void)
+    int Frame::nic_rx_burst(unsigned arg_max, rx_burst &arg_burst)
     {
-        struct pcap_pkthdr *hdr;
-        const uint8_t      *pkt;
-        int                 ret;
-        uint32_t            len_min;
-
-        #ifndef PCAP_DISABLE
-            ret = pcap_next_ex(this->nic_handle, &hdr, &pkt);
-
-            if (ret == 0)
-            {
-                cerr << "Frame::nic_rx_frame(): timeout" << endl << flush;
-                return false;
-            }
-            else if (ret == -1)
-            {
-                pcap_perror(this->nic_handle, "Frame::nic_rx_frame(): failure");
-                return false;
-            }
-            else if (ret == -2)
-            {
-                cerr << "Frame::nic_rx_frame(): savefile EOF" << endl << flush;
-                return false;
-            }
-
-            if (hdr->caplen < hdr->len)
-            {
-                    len_min = hdr->caplen;
-            }
-            else
-            {
-                    len_min = hdr->len;
-            }
-
-            if (false)
-            {
-                cerr << "Frame::nic_rx_frame(): caplen is  " << hdr->caplen << endl << flush;
-                cerr << "Frame::nic_rx_frame(): len is     " << hdr->len << endl << flush;
-                cerr << "Frame::nic_rx_frame(): len_min is " << len_min << endl << flush;
-            }
-
-            for (uint32_t i = 0 ; i < len_min ; i++)
-            {
-                this->frame.bytes.push_back(pkt[i]);
-            }
-
-            this->frame.valid = true;
-        #endif
+        arg_burst.count = 0;
 
-        return true;
+        if (not this->nic_ready("nic_rx_burst")) return -1;
+
+        return this->nic->rx_burst(arg_max, arg_burst);
+    }
+
+    int Frame::nic_rx_view(unsigned arg_max, ViewHandler arg_handler)
+    {
+        if (not this->nic_ready("nic_rx_view")) return -1;
+
+        return this->nic->rx_view(arg_max, arg_handler);
+    }
+
+    int Frame::nic_rx_bufs(unsigned arg_max, vector<Buf> &arg_bufs)
+    {
+        arg_bufs.clear();
+
+        if (not this->nic_ready("nic_rx_bufs")) return -1;
+
+        return this->nic->rx_bufs(arg_max, arg_bufs);
     }
 
     bool Frame::nic_tx_frame(void)
     {
-        int ret;
+        if (not this->nic_ready("nic_tx_frame")) return false;
 
-        #ifndef PCAP_DISABLE
-            ret = pcap_inject(this->nic_handle, frame.bytes.data(), frame.bytes.size());
+        if (not this->nic->tx_frame(this->frame.bytes.data(), this->frame.bytes.size())) return false;
 
-            if (ret < 0)
-            {
-                pcap_perror(this->nic_handle, "Frame::nic_tx_frame(): failure");
-                return false;
-            }
+        this->frame.valid = false;
+        this->frame.bytes.clear();
 
-            if (false)
-            {
-                cerr << "Frame::nic_tx_frame(): okay" << endl << flush;
-            }
+        return true;
+    }
 
-            this->frame.valid = false;
-            this->frame.bytes.clear();
-        #endif
+    bool Frame::nic_tx_queue(void)
+    {
+        if (not this->nic_ready("nic_tx_queue")) return false;
+
+        if (not this->nic->tx_queue(this->frame.bytes)) return false;
+
+        this->frame.valid = false;
+        this->frame.bytes.clear();
 
         return true;
     }
 
+    int Frame::nic_tx_flush(vector<int> &arg_results)
+    {
+        arg_results.clear();
+
+        if (not this->nic_ready("nic_tx_flush")) return -1;
+
+        return this->nic->tx_flush(arg_results);
+    }
+
+    unsigned Frame::nic_tx_depth(void)
+    {
+        if (not this->nic) return 0;
+
+        return this->nic->tx_depth();
+    }
+
     bool Frame::get_frame_byte(uint8_t &arg_byte)
     {
         if (not this->frame.valid)
@@ -256,22 +305,17 @@ namespace Frames
 
         if (this->iter_idle)
         {
-            this->iter_idle = false;
-            this->iter_pos  = this->frame.bytes.begin();
-        }
-        else
-        {
-            ++this->iter_pos;
+            this->iter_idle   = false;
+            this->iter_cursor = FrameCursor(this->frame.bytes);
         }
 
-        if (this->iter_pos == this->frame.bytes.end())
+        if (not this->iter_cursor.read_u8(arg_byte))
         {
             this->frame.valid = false;
             this->iter_idle   = true;
             return false;
         }
 
-        arg_byte = (*this->iter_pos);
         return true;
     }
 
@@ -282,47 +326,53 @@ namespace Frames
 
     string Frame::gist_bytes(BVec &arg_bytes)
     {
-        bool   tmp = false;
-        stringstream ss;
-
-        ss  << "bytes:{";
+        return this->gist_bytes(arg_bytes.data(), arg_bytes.size());
+    }
 
-        if (arg_bytes.empty())
-        {
-            ss  << "empty";
-        }
-        else
-        {
-            for (auto it = arg_bytes.begin() ; it != arg_bytes.end() ; ++it)
-            {
-                if (tmp == true) ss << ",";
-                ss  << "0x"<< setfill('0') << setw(2) << hex << (int)(*it);
-                tmp = true;
-            }
-        }
+    string Frame::gist_bytes(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        string   text;
+        FrameFmt fmt(text);
 
-        ss  << "}";
+        fmt.gist_bytes(arg_bytes, arg_len);
 
-        return ss.str();
+        return text;
     }
 
     string Frame::gist_item(item& arg_item)
     {
-        stringstream ss;
+        string   text;
+        FrameFmt fmt(text);
+
+        fmt.gist_item(arg_item);
 
-        ss  << "{valid:" << boolalpha << arg_item.valid
-            << ","+this->gist_bytes(arg_item.bytes)
-            << "}";
+        return text;
+    }
 
-        return ss.str();
+    string Frame::gist_field(field &arg_field)
+    {
+        string   text;
+        FrameFmt fmt(text);
+
+        fmt.gist_field(arg_field);
+
+        return text;
+    }
+
+    void Frame::gist_to(FrameFmt &arg_fmt)
+    {
+        arg_fmt.put("{frame:");
+        arg_fmt.gist_item(this->frame);
+        arg_fmt.put("}");
     }
 
     string Frame::gist(void)
     {
-        stringstream ss;
+        string   text;
+        FrameFmt fmt(text);
 
-        ss << "{frame:" << this->gist_item(this->frame) << "}";
+        this->gist_to(fmt);
 
-        return ss.str();
+        return text;
     }
 }
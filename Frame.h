@@ -21,10 +21,13 @@
     #define _FRAME_RAW_H_
 
     #include <cstdint>
+    #include <memory>
     #include <string>
     #include <vector>
     #include <array>
     #include <pcap.h>
+    #include <FrameView.h>
+    #include <FrameCursor.h>
 
     namespace Frames
     {
@@ -33,42 +36,91 @@
         typedef std::vector<uint8_t>::const_iterator BVecConstIter;
         typedef struct bpf_program pcap_bpf;
 
+        const unsigned NicSnapLen    = 65536;
+        const unsigned RxSlotReserve = 2048;
+        const unsigned FieldMaxBytes = 16;
+
+        class Nic;
+        class Buf;
+        class FrameFmt;
+
         struct item
         {
             bool    valid;
             BVec    bytes;
         };
 
+        struct field
+        {
+            bool    valid;
+            uint8_t size;
+            uint8_t bytes[FieldMaxBytes];
+
+            void set(const uint8_t *arg_bytes, unsigned arg_len);
+            void append(const uint8_t *arg_bytes, unsigned arg_len);
+            void clear(void);
+        };
+
+        struct rx_slot
+        {
+            struct pcap_pkthdr hdr;
+            BVec               bytes;
+        };
+
+        struct rx_burst
+        {
+            unsigned             count;
+            std::vector<rx_slot> slots;
+
+            rx_burst(unsigned arg_slots = 0, unsigned arg_reserve = RxSlotReserve);
+            void reserve(unsigned arg_slots, unsigned arg_reserve = RxSlotReserve);
+        };
+
         class Frame
         {
             private:
                 item         frame;
                 bool         iter_idle;
-                BVecIter     iter_pos;
-                char         nic_errbuf[PCAP_ERRBUF_SIZE];
-                pcap_t      *nic_handle;
-                pcap_bpf     nic_bpf;
+                FrameCursor  iter_cursor;
+                std::shared_ptr<Nic> nic;
+
+                bool nic_ready(const char *arg_who);
 
             public:
                 Frame(void);
                 virtual ~Frame(void);
 
                 void give_frame(BVec &&arg_bytes);
+                void load_frame(const uint8_t *arg_bytes, std::size_t arg_len);
                 void copy_frame(BVec &arg_bytes);
                 void take_frame(BVec &arg_bytes);
+                const BVec & peek_frame(void);
+                Buf share_frame(void);
+                FrameCursor cursor_frame(void);
                 static BVec & to_bvec(BVec & arg_bvec, const uint64_t arg_uint, const unsigned int arg_len = 8);
                 static BVec & to_bvec(BVec & arg_bvec, const uint32_t arg_uint, const unsigned int arg_len = 4);
                 static BVec & to_bvec(BVec & arg_bvec, const uint16_t arg_uint, const unsigned int arg_len = 2);
                 static BVec & to_bvec(BVec & arg_bvec, const uint8_t  arg_uint, const unsigned int arg_len = 1);
                 bool nic_open(std::string arg_nic_name);
+                bool nic_open_offline(std::string arg_path, bool arg_nano = false);
+                bool nic_attach(Nic &arg_nic);
                 void nic_close(void);
                 bool nic_rx_filter(std::string arg_expr);
                 bool nic_rx_frame(void);
+                int  nic_rx_burst(unsigned arg_max, rx_burst &arg_burst);
+                int  nic_rx_view(unsigned arg_max, ViewHandler arg_handler);
+                int  nic_rx_bufs(unsigned arg_max, std::vector<Buf> &arg_bufs);
                 bool nic_tx_frame(void);
+                bool nic_tx_queue(void);
+                int  nic_tx_flush(std::vector<int> &arg_results);
+                unsigned nic_tx_depth(void);
                 bool get_frame_byte(uint8_t &arg_byte);
                 std::string gist_bytes();
                 std::string gist_bytes(BVec &arg_bytes);
+                std::string gist_bytes(const uint8_t *arg_bytes, std::size_t arg_len);
                 std::string gist_item(item &arg_item);
+                std::string gist_field(field &arg_field);
+                virtual void gist_to(FrameFmt &arg_fmt);
                 virtual std::string gist(void);
         };
     }
@@ -17,9 +17,9 @@
  *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <ByteWriter.h>
+#include <FrameFmt.h>
 #include <FrameArp.h>
 
 namespace Frames
@@ -28,11 +28,11 @@ namespace Frames
 
     FrameArp::FrameArp(void) : FrameEth()
     {
-        this->spec[ ARP_OP   ] = {false, BVec()};
-        this->spec[ ARP_QMAC ] = {false, BVec()};
-        this->spec[ ARP_QIP  ] = {false, BVec()};
-        this->spec[ ARP_TMAC ] = {false, BVec()};
-        this->spec[ ARP_TIP  ] = {false, BVec()};
+        this->spec[ ARP_OP   ].clear();
+        this->spec[ ARP_QMAC ].clear();
+        this->spec[ ARP_QIP  ].clear();
+        this->spec[ ARP_TMAC ].clear();
+        this->spec[ ARP_TIP  ].clear();
 
         this->spec_op = ArpOp::OP_NIL;
     }
@@ -41,8 +41,9 @@ namespace Frames
 
     void FrameArp::set_arp_op(ArpOp arg_op)
     {
-        this->spec[ARP_OP].bytes.push_back((uint8_t)arg_op);
-        this->spec[ARP_OP].valid = true;
+        uint8_t op = (uint8_t)arg_op;
+
+        this->spec[ARP_OP].set(&op, 1);
 
         this->spec_op = arg_op;
     }
@@ -55,8 +56,7 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ARP_QMAC].bytes.insert(this->spec[ARP_QMAC].bytes.end(), arg_qmac.begin(), arg_qmac.end());
-        this->spec[ARP_QMAC].valid = true;
+        this->spec[ARP_QMAC].set(arg_qmac.data(), 6);
     }
 
     void FrameArp::set_arp_qip(const BVec &arg_qip)
@@ -67,8 +67,7 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ARP_QIP].bytes.insert(this->spec[ARP_QIP].bytes.end(), arg_qip.begin(), arg_qip.end());
-        this->spec[ARP_QIP].valid = true;
+        this->spec[ARP_QIP].set(arg_qip.data(), 4);
     }
 
     void FrameArp::set_arp_tmac(const BVec &arg_tmac)
@@ -79,8 +78,7 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ARP_TMAC].bytes.insert(this->spec[ARP_TMAC].bytes.end(), arg_tmac.begin(), arg_tmac.end());
-        this->spec[ARP_TMAC].valid = true;
+        this->spec[ARP_TMAC].set(arg_tmac.data(), 6);
     }
 
     void FrameArp::set_arp_tip(const BVec &arg_tip)
@@ -91,16 +89,13 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ARP_TIP].bytes.insert(this->spec[ARP_TIP].bytes.end(), arg_tip.begin(), arg_tip.end());
-        this->spec[ARP_TIP].valid = true;
+        this->spec[ARP_TIP].set(arg_tip.data(), 4);
     }
 
     void FrameArp::encapsulate(void)
     {
         bool   okay    = true;
         string errmsg  = "[ERR] encapsulate(): cannot encapsulate with an invalid";
-        BVec   pr_type;
-        BVec   ip_bcst;
         BVec   bytes;
 
         if (not this->spec[ ARP_OP   ].valid) okay = false;
@@ -117,72 +112,53 @@ namespace Frames
 
         if (not okay) exit(1);
 
-        this->get_vec_eth_type(pr_type, EtherType::ETYP_IPV4);
-
-        ip_bcst.push_back(MAC_BCST[0]);
-        ip_bcst.push_back(MAC_BCST[1]);
-        ip_bcst.push_back(MAC_BCST[2]);
-        ip_bcst.push_back(MAC_BCST[3]);
-        ip_bcst.push_back(MAC_BCST[4]);
-        ip_bcst.push_back(MAC_BCST[5]);
+        ByteWriter bw(bytes, 28 + ARP_PAD_SIZE);
 
-        bytes.push_back(ARP_HW_TYP[0]);
-        bytes.push_back(ARP_HW_TYP[1]);
-        bytes.insert(bytes.end(), pr_type.begin(), pr_type.end());
-        bytes.push_back(ARP_HW_SIZ);
-        bytes.push_back(ARP_PR_SIZ);
-        bytes.push_back(0x00);
-        bytes.insert(bytes.end(), this->spec[ARP_OP].bytes.begin(), this->spec[ARP_OP].bytes.end());
+        bw.put_bytes(ARP_HW_TYP, 2);
+        bw.put_u16((uint16_t)EtherType::ETYP_IPV4);
+        bw.put_u8(ARP_HW_SIZ);
+        bw.put_u8(ARP_PR_SIZ);
+        bw.put_u8(0x00);
+        bw.put_bytes(this->spec[ARP_OP].bytes, 1);
 
         if (this->spec_op == ArpOp::OP_REQ)
         {
-            bytes.insert(bytes.end(), this->spec[ ARP_QMAC ].bytes.begin(), this->spec[ ARP_QMAC ].bytes.end());
-            bytes.insert(bytes.end(), this->spec[ ARP_QIP  ].bytes.begin(), this->spec[ ARP_QIP  ].bytes.end());
-            bytes.push_back(0x00);
-            bytes.push_back(0x00);
-            bytes.push_back(0x00);
-            bytes.push_back(0x00);
-            bytes.push_back(0x00);
-            bytes.push_back(0x00);
-            bytes.insert(bytes.end(), this->spec[ ARP_TIP  ].bytes.begin(), this->spec[ ARP_TIP  ].bytes.end());
-
-            this->set_eth_dmac(ip_bcst);
+            bw.put_bytes(this->spec[ARP_QMAC].bytes, 6);
+            bw.put_bytes(this->spec[ARP_QIP].bytes, 4);
+            bw.put_fill(0x00, 6);
+            bw.put_bytes(this->spec[ARP_TIP].bytes, 4);
+
+            this->set_eth_dmac(MAC_BCST);
             this->set_eth_smac(this->spec[ARP_QMAC].bytes);
         }
         else
         {
-            bytes.insert(bytes.end(), this->spec[ ARP_TMAC ].bytes.begin(), this->spec[ ARP_TMAC ].bytes.end());
-            bytes.insert(bytes.end(), this->spec[ ARP_TIP  ].bytes.begin(), this->spec[ ARP_TIP  ].bytes.end());
-            bytes.insert(bytes.end(), this->spec[ ARP_QMAC ].bytes.begin(), this->spec[ ARP_QMAC ].bytes.end());
-            bytes.insert(bytes.end(), this->spec[ ARP_QIP  ].bytes.begin(), this->spec[ ARP_QIP  ].bytes.end());
+            bw.put_bytes(this->spec[ARP_TMAC].bytes, 6);
+            bw.put_bytes(this->spec[ARP_TIP].bytes, 4);
+            bw.put_bytes(this->spec[ARP_QMAC].bytes, 6);
+            bw.put_bytes(this->spec[ARP_QIP].bytes, 4);
 
             this->set_eth_dmac(this->spec[ARP_QMAC].bytes);
             this->set_eth_smac(this->spec[ARP_TMAC].bytes);
         }
 
-        for (unsigned int i = 0 ; i < ARP_PAD_SIZE ; ++i)
-        {
-            bytes.push_back(0x00);
-        }
+        bw.put_fill(0x00, ARP_PAD_SIZE);
+        bw.finish();
 
         this->set_eth_type(EtherType::ETYP_IPV4);
-        this->set_eth_payload(bytes);
+        this->set_eth_payload(move(bytes));
         FrameEth::encapsulate();
     }
-    string FrameArp::gist(void)
+    void FrameArp::gist_to(FrameFmt &arg_fmt)
     {
-        stringstream ss;
-
-        ss  << "{spec:"
-            << "ARP_OP:"    << gist_item(this->spec[ARP_OP])
-            << ",ARP_QMAC:" << gist_item(this->spec[ARP_QMAC])
-            << ",ARP_QIP:"  << gist_item(this->spec[ARP_QIP])
-            << ",ARP_TMAC:" << gist_item(this->spec[ARP_TMAC])
-            << ",ARP_TIP:"  << gist_item(this->spec[ARP_TIP])
-            << ",frame:"    << FrameEth::gist()
-            << "}";
-
-        return ss.str();
+        arg_fmt.put("{spec:");
+        arg_fmt.put("ARP_OP:");    arg_fmt.gist_field(this->spec[ARP_OP]);
+        arg_fmt.put(",ARP_QMAC:"); arg_fmt.gist_field(this->spec[ARP_QMAC]);
+        arg_fmt.put(",ARP_QIP:");  arg_fmt.gist_field(this->spec[ARP_QIP]);
+        arg_fmt.put(",ARP_TMAC:"); arg_fmt.gist_field(this->spec[ARP_TMAC]);
+        arg_fmt.put(",ARP_TIP:");  arg_fmt.gist_field(this->spec[ARP_TIP]);
+        arg_fmt.put(",frame:");    FrameEth::gist_to(arg_fmt);
+        arg_fmt.put("}");
     }
 
 }
@@ -41,8 +41,8 @@
         class FrameArp : public FrameEth
         {
             private:
-                std::unordered_map<ArpField, item> spec;
-                ArpOp                              spec_op;
+                std::array<field, ARP_TIP + 1> spec;
+                ArpOp                          spec_op;
 
             public:
                 FrameArp(void);
@@ -54,7 +54,7 @@
                 void set_arp_tmac(const BVec &arg_tmac);
                 void set_arp_tip(const BVec &arg_tip);
                 virtual void encapsulate(void);
-                virtual std::string gist(void);
+                virtual void gist_to(FrameFmt &arg_fmt);
         };
     }
 #endif
@@ -0,0 +1,1376 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <pcap.h>
+#include <Frame.h>
+#include <FrameEth.h>
+#include <FrameVlan.h>
+#include <FrameQinq.h>
+#include <FrameIPv4.h>
+#include <FrameUdp.h>
+#include <FrameArp.h>
+#include <FramePause.h>
+#include <FrameStack.h>
+#include <FrameTemplate.h>
+#include <FrameRewrite.h>
+#include <FrameDecode.h>
+#include <FrameFmt.h>
+#include <Cksum.h>
+#include <FlowHash.h>
+#include <BufPool.h>
+#include <NicPcapFile.h>
+#include <NicRing.h>
+#include <NicWire.h>
+#include <PcapMap.h>
+#include <PcapWriter.h>
+#include <PcapngMap.h>
+#include <PcapngWriter.h>
+#include <RxPipeline.h>
+
+#ifndef BENCH_VERSION
+    #define BENCH_VERSION "unknown"
+#endif
+
+#ifndef BENCH_CFLAGS
+    #define BENCH_CFLAGS "unknown"
+#endif
+
+using namespace std;
+using namespace Frames;
+
+const BVec      bench_dmac   = {0x30,0x9c,0x23,0x1c,0x68,0x47};
+const BVec      bench_smac   = {0x40,0x6c,0x8f,0x19,0x7c,0x7d};
+const BVec      bench_sip    = {0x0a,0x00,0x00,0x01};
+const BVec      bench_dip    = {0x0a,0x00,0x00,0x02};
+const uint16_t  bench_etyp   = 0x88B5;
+
+const unsigned  BenchSlices    = 64;
+const unsigned  BenchBatch     = 32;
+const unsigned  BenchPcapCount = 4096;
+const unsigned  BenchFlows     = 64;
+const unsigned  BenchMaxOps    = 1 << 30;
+const unsigned  BenchSizes[]   = {64, 128, 594, 1518};
+
+// -- allocation counting -------------------------------------------------------
+// Replacing the global operator new also counts the library's allocations.
+
+static atomic<uint64_t> bench_allocs(0);
+static volatile uint64_t bench_sink;
+
+// set-up time a case adds here is left out of its timing
+static double bench_setup_ns;
+
+void * operator new(size_t arg_len)
+{
+    void *ptr = malloc(arg_len ? arg_len : 1);
+
+    if (ptr == NULL) throw bad_alloc();
+
+    bench_allocs.fetch_add(1, memory_order_relaxed);
+
+    return ptr;
+}
+
+void operator delete(void *arg_ptr) noexcept
+{
+    free(arg_ptr);
+}
+
+// -- cases ---------------------------------------------------------------------
+
+// handled, when set, is filled by the case with the frames each pipeline
+// worker handled in its last run, for the balance of the flow dispatch
+
+struct bench_case
+{
+    string                         name;
+    double                         frames;
+    double                         bytes;
+    function<void(uint64_t arg_n)> run;
+    shared_ptr<vector<uint64_t>>   handled;
+
+    bench_case(string arg_name, double arg_frames, double arg_bytes, function<void(uint64_t arg_n)> arg_run,
+               shared_ptr<vector<uint64_t>> arg_handled = nullptr)
+        : name(arg_name), frames(arg_frames), bytes(arg_bytes), run(arg_run), handled(arg_handled) { }
+};
+
+struct bench_result
+{
+    string           name;
+    uint64_t         ops;
+    unsigned         reps;
+    double           ns_op;
+    double           ns_min;
+    double           p50;
+    double           p90;
+    double           p99;
+    double           frames_sec;
+    double           bytes_sec;
+    double           allocs_op;
+    vector<uint64_t> handled;
+};
+
+struct bench_fix
+{
+    BVec               payload;
+    BVec               mtu_ipv4;
+    BVec               mtu_udp;
+    BVec               jumbo;
+    BVec               frame;
+    vector<BVec>       frames;
+    vector<FrameView>  views;
+    vector<flow_key>   keys;
+    vector<uint32_t>   hashes;
+    vector<frame_info> infos;
+    string             pcap;
+    string             pcapng;
+    string             tx_nic;
+};
+
+static double ns_since(chrono::steady_clock::time_point arg_t0)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - arg_t0).count();
+}
+
+static void build_udp(FrameUdp &arg_udp, size_t arg_payload)
+{
+    arg_udp.set_eth_dmac(bench_dmac);
+    arg_udp.set_eth_smac(bench_smac);
+    arg_udp.set_ipv4_sip(bench_sip);
+    arg_udp.set_ipv4_dip(bench_dip);
+    arg_udp.set_udp_sport(1024);
+    arg_udp.set_udp_dport(9);
+    arg_udp.set_udp_payload(BVec(arg_payload, 0x5A));
+    arg_udp.encapsulate();
+}
+
+// The capture replayed by the pcap and pipeline cases: UDP frames over
+// BenchFlows flows, cycling through BenchSizes (sizes with FCS).  The
+// source address and port must not step together: the symmetric key's
+// hash is linear, and equal steps in both cancel out.
+
+static bool build_pcap(bench_fix &arg_fix)
+{
+    vector<FrameTemplate> tpls(4);
+    PcapWriter            writer;
+
+    for (unsigned i = 0 ; i < 4 ; i++)
+    {
+        FrameUdp udp;
+        BVec     bytes;
+
+        build_udp(udp, BenchSizes[i] - 4 - 42);
+        udp.copy_frame(bytes);
+        tpls[i].capture(bytes.data(), bytes.size());
+    }
+
+    if (not writer.open(arg_fix.pcap, true)) return false;
+
+    for (unsigned i = 0 ; i < BenchPcapCount ; i++)
+    {
+        FrameTemplate  &tpl   = tpls[i % 4];
+        unsigned        flow  = i % BenchFlows;
+        BVec            bytes = tpl.peek_image();
+        struct timespec ts    = {(time_t)i, 0};
+
+        tpl.patch(bytes.data(), tpl.find_patch("ipv4.sip"), 0x0a000001 + flow);
+        tpl.patch(bytes.data(), tpl.find_patch("udp.sport"), 1024 + flow * 7);
+
+        if (not writer.write(bytes.data(), bytes.size(), ts)) return false;
+
+        arg_fix.frames.push_back(bytes);
+    }
+
+    for (BVec &bytes : arg_fix.frames)
+    {
+        FrameView view;
+
+        view.data   = bytes.data();
+        view.caplen = bytes.size();
+        view.len    = bytes.size();
+        arg_fix.views.push_back(view);
+    }
+
+    return writer.close();
+}
+
+// -- self-checks ---------------------------------------------------------------
+// Every checksum path against the byte-wise reference, over random bytes at
+// random offsets and odd and even lengths.
+
+const unsigned CheckCksumRuns = 20000;
+
+static bool check_cksum(void)
+{
+    const CksumPath paths[] = {CksumPath::PATH_SCALAR, CksumPath::PATH_SSE2, CksumPath::PATH_AVX2};
+    mt19937         rng(1071);
+    BVec            bytes(9000 + 64);
+    unsigned        bad = 0;
+
+    for (uint8_t &b : bytes) b = (uint8_t)rng();
+
+    for (unsigned i = 0 ; i < CheckCksumRuns ; i++)
+    {
+        size_t   off  = rng() % 64;
+        size_t   len  = (i % 4) ? rng() % 128 : rng() % 9001;
+        uint16_t seed = (uint16_t)rng();
+        uint16_t want = Cksum::sum_ref(bytes.data() + off, len, seed);
+
+        for (CksumPath path : paths)
+        {
+            if (not Cksum::has_path(path)) continue;
+
+            if (Cksum::sum(path, bytes.data() + off, len, seed) != want)
+            {
+                if (bad++ < 8)
+                {
+                    cerr << "FrameBench: cksum " << Cksum::get_path_name(path) << " mismatch at offset "
+                         << off << " length " << len << endl << flush;
+                }
+            }
+        }
+
+        if (Cksum::sum(bytes.data() + off, len, seed) != want) bad++;
+    }
+
+    return bad == 0;
+}
+
+// The same frames again as pcapng, for the pcapng cases.
+
+static bool build_pcapng(bench_fix &arg_fix)
+{
+    PcapngWriter writer;
+
+    if (not writer.open(arg_fix.pcapng) or writer.add_interface("bench") < 0) return false;
+
+    for (unsigned i = 0 ; i < arg_fix.frames.size() ; i++)
+    {
+        struct timespec ts = {(time_t)i, 0};
+
+        if (not writer.write(0, arg_fix.frames[i].data(), arg_fix.frames[i].size(), ts)) return false;
+    }
+
+    return writer.close();
+}
+
+static void add_frame_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    bench_fix &fx = arg_fix;
+
+    arg_cases.push_back({"eth.encapsulate", 1, 60, [&fx](uint64_t arg_n)
+    {
+        FrameEth frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_eth_type(bench_etyp);
+            frame.set_eth_payload(fx.payload);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    arg_cases.push_back({"eth.insert_vlan.encapsulate", 1, 64, [&fx](uint64_t arg_n)
+    {
+        FrameEth frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            insert_vlan(frame, 100);
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_eth_type(bench_etyp);
+            frame.set_eth_payload(fx.payload);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    arg_cases.push_back({"eth.insert_qinq.encapsulate", 1, 68, [&fx](uint64_t arg_n)
+    {
+        FrameEth frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            insert_qinq(frame, 200);
+            insert_vlan(frame, 100);
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_eth_type(bench_etyp);
+            frame.set_eth_payload(fx.payload);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    // FrameIPv4 keeps its payload after encapsulate(), so each op starts
+    // from a new frame
+    arg_cases.push_back({"ipv4.encapsulate", 1, 80, [&fx](uint64_t arg_n)
+    {
+        size_t len = 0;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            FrameIPv4 frame;
+
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_ipv4_proto(IPv4Proto::PROTO_UDP);
+            frame.set_ipv4_sip(bench_sip);
+            frame.set_ipv4_dip(bench_dip);
+            frame.set_ipv4_payload(fx.payload);
+            frame.encapsulate();
+            len = frame.peek_frame().size();
+        }
+
+        bench_sink += len;
+    }});
+
+    arg_cases.push_back({"udp.encapsulate", 1, 88, [&fx](uint64_t arg_n)
+    {
+        FrameUdp frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) build_udp(frame, fx.payload.size());
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    // a full 1514-byte frame: a 1500-byte IPv4 packet, and a 1472-byte
+    // UDP payload; the payload should be written once either way
+    arg_cases.push_back({"ipv4.encapsulate.1500", 1, 1514, [&fx](uint64_t arg_n)
+    {
+        size_t len = 0;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            FrameIPv4 frame;
+
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_ipv4_proto(IPv4Proto::PROTO_UDP);
+            frame.set_ipv4_sip(bench_sip);
+            frame.set_ipv4_dip(bench_dip);
+            frame.set_ipv4_payload(fx.mtu_ipv4);
+            frame.encapsulate();
+            len = frame.peek_frame().size();
+        }
+
+        bench_sink += len;
+    }});
+
+    arg_cases.push_back({"udp.encapsulate.1472", 1, 1514, [&fx](uint64_t arg_n)
+    {
+        FrameUdp frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_ipv4_sip(bench_sip);
+            frame.set_ipv4_dip(bench_dip);
+            frame.set_udp_sport(1024);
+            frame.set_udp_dport(9);
+            frame.set_udp_payload(fx.mtu_udp);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    arg_cases.push_back({"udp.encapsulate_batch", BenchBatch, BenchBatch * 88.0, [&fx](uint64_t arg_n)
+    {
+        FrameUdp     frame;
+        vector<Buf>  bufs;
+        udp_datagram dgrams[BenchBatch];
+
+        for (unsigned i = 0 ; i < BenchBatch ; i++) dgrams[i] = {(uint16_t)(1024 + i), 9, fx.payload.data(), fx.payload.size()};
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.set_eth_dmac(bench_dmac);
+            frame.set_eth_smac(bench_smac);
+            frame.set_ipv4_sip(bench_sip);
+            frame.set_ipv4_dip(bench_dip);
+            frame.encapsulate_batch(dgrams, BenchBatch, bufs);
+        }
+
+        bench_sink += bufs.size();
+    }});
+
+    arg_cases.push_back({"arp.encapsulate", 1, 60, [&fx](uint64_t arg_n)
+    {
+        FrameArp frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.set_arp_op(ArpOp::OP_REQ);
+            frame.set_arp_qmac(bench_smac);
+            frame.set_arp_qip(bench_sip);
+            frame.set_arp_tmac(bench_dmac);
+            frame.set_arp_tip(bench_dip);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    arg_cases.push_back({"pause.encapsulate", 1, 60, [&fx](uint64_t arg_n)
+    {
+        FramePause frame;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.set_eth_smac(bench_smac);
+            frame.set_pause_param(0xFFFF);
+            frame.encapsulate();
+        }
+
+        bench_sink += frame.peek_frame().size();
+    }});
+
+    arg_cases.push_back({"stack.udp.emit", 1, 88, [&fx](uint64_t arg_n)
+    {
+        FrameStack<StackEth, StackIPv4, StackUdp> stack;
+        uint8_t                                   buf[128];
+
+        memcpy(stack.layer<0>().dmac, bench_dmac.data(), 6);
+        memcpy(stack.layer<0>().smac, bench_smac.data(), 6);
+        memcpy(stack.layer<1>().sip, bench_sip.data(), 4);
+        memcpy(stack.layer<1>().dip, bench_dip.data(), 4);
+        stack.layer<2>() = {1024, 9};
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) bench_sink += stack.emit(buf, fx.payload.data(), fx.payload.size());
+    }});
+
+    arg_cases.push_back({"stack.qinq_udp.emit", 1, 96, [&fx](uint64_t arg_n)
+    {
+        FrameStack<StackEth, StackQinq, StackVlan, StackIPv4, StackUdp> stack;
+        uint8_t                                                          buf[128];
+
+        memcpy(stack.layer<0>().dmac, bench_dmac.data(), 6);
+        memcpy(stack.layer<0>().smac, bench_smac.data(), 6);
+        stack.layer<1>().tci = 200;
+        stack.layer<2>().tci = 100;
+        memcpy(stack.layer<3>().sip, bench_sip.data(), 4);
+        memcpy(stack.layer<3>().dip, bench_dip.data(), 4);
+        stack.layer<4>() = {1024, 9};
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) bench_sink += stack.emit(buf, fx.payload.data(), fx.payload.size());
+    }});
+
+    arg_cases.push_back({"template.stamp_patch", 1, 88, [&fx](uint64_t arg_n)
+    {
+        FrameTemplate tpl;
+        uint8_t       buf[128];
+        int           sport;
+
+        tpl.capture(fx.frame.data(), fx.frame.size());
+        sport = tpl.find_patch("udp.sport");
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            tpl.stamp(buf);
+            tpl.patch(buf, sport, (uint64_t)(i & 0xFFFF));
+        }
+
+        bench_sink += buf[34];
+    }});
+
+    arg_cases.push_back({"rewrite.swap_ttl_port", 1, 88, [&fx](uint64_t arg_n)
+    {
+        FrameRewrite rw;
+        BVec         bytes = fx.frame;
+
+        rw.bind(bytes.data(), bytes.size());
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            rw.swap_eth_macs();
+            rw.set_ipv4_ttl(64);
+            rw.dec_ipv4_ttl();
+            rw.set_l4_sport((uint16_t)i);
+        }
+
+        bench_sink += bytes[22];
+    }});
+}
+
+static void add_cksum_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    const CksumPath paths[] = {CksumPath::PATH_SCALAR, CksumPath::PATH_SSE2, CksumPath::PATH_AVX2};
+    const size_t    lens[]  = {20, 1500, 65536};
+    bench_fix      &fx      = arg_fix;
+
+    for (CksumPath path : paths)
+    {
+        if (not Cksum::has_path(path)) continue;
+
+        for (size_t len : lens)
+        {
+            string name = string("cksum.") + Cksum::get_path_name(path) + "." + to_string(len);
+
+            arg_cases.push_back({name, 0, (double)len, [&fx, path, len](uint64_t arg_n)
+            {
+                uint16_t sum = 0;
+
+                for (uint64_t i = 0 ; i < arg_n ; i++) sum = Cksum::sum(path, fx.jumbo.data(), len, sum);
+
+                bench_sink += sum;
+            }});
+        }
+    }
+
+    for (size_t len : {20, 1500})
+    {
+        arg_cases.push_back({"cksum.ref." + to_string(len), 0, (double)len, [&fx, len](uint64_t arg_n)
+        {
+            uint16_t sum = 0;
+
+            for (uint64_t i = 0 ; i < arg_n ; i++) sum = Cksum::sum_ref(fx.jumbo.data(), len, sum);
+
+            bench_sink += sum;
+        }});
+    }
+
+    arg_cases.push_back({"ipv4.cksum_calc", 0, 20, [&fx](uint64_t arg_n)
+    {
+        FrameIPv4 frame;
+        uint32_t  sum = 0;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) sum += frame.cksum_calc(fx.frame.data() + 14, 20);
+
+        bench_sink += sum;
+    }});
+}
+
+// The stringstream gist() that FrameFmt replaced, kept as the reference for
+// the gist cases: one stream and one temporary string per level, item and
+// byte list.  The fields are read back from an encapsulated UDP frame.
+
+static string gist_ss_bytes(const BVec &arg_bytes)
+{
+    bool         tmp = false;
+    stringstream ss;
+
+    ss  << "bytes:{";
+
+    if (arg_bytes.empty())
+    {
+        ss  << "empty";
+    }
+    else
+    {
+        for (auto it = arg_bytes.begin() ; it != arg_bytes.end() ; ++it)
+        {
+            if (tmp == true) ss << ",";
+            ss  << "0x"<< setfill('0') << setw(2) << hex << (int)(*it);
+            tmp = true;
+        }
+    }
+
+    ss  << "}";
+
+    return ss.str();
+}
+
+static string gist_ss_item(bool arg_valid, const BVec &arg_bytes)
+{
+    stringstream ss;
+
+    ss  << "{valid:" << boolalpha << arg_valid
+        << ","+gist_ss_bytes(arg_bytes)
+        << "}";
+
+    return ss.str();
+}
+
+static string gist_ss_eth(const BVec &arg_frame)
+{
+    const BVec   none;
+    stringstream ss;
+
+    ss  << "{spec:"
+        << "ETH_DMAC:"        << gist_ss_item(false, none)
+        << ",ETH_SMAC:"       << gist_ss_item(false, none)
+        << ",ETH_TYPE_ENCAP:" << gist_ss_item(false, none)
+        << ",ETH_PAYLOAD:"    << gist_ss_item(false, none)
+        << ",frame:{frame:"   << gist_ss_item(true, arg_frame) << "}"
+        << "}";
+
+    return ss.str();
+}
+
+static string gist_ss_ipv4(const BVec &arg_frame)
+{
+    const BVec   none;
+    stringstream ss;
+
+    ss  << "{spec:"
+        << ",IPV4_PROTO:"   << gist_ss_item(true, BVec(arg_frame.begin() + 23, arg_frame.begin() + 24))
+        << ",IPV4_SIP:"     << gist_ss_item(true, BVec(arg_frame.begin() + 26, arg_frame.begin() + 30))
+        << ",IPV4_DIP:"     << gist_ss_item(true, BVec(arg_frame.begin() + 30, arg_frame.begin() + 34))
+        << ",IPV4_PAYLOAD:" << gist_ss_item(false, none)
+        << ",frame:"        << gist_ss_eth(arg_frame)
+        << "}";
+
+    return ss.str();
+}
+
+static string gist_ss_udp(const BVec &arg_frame)
+{
+    const BVec   none;
+    stringstream ss;
+
+    ss  << "{spec:"
+        << "UDP_SPORT:"    << gist_ss_item(true, BVec(arg_frame.begin() + 34, arg_frame.begin() + 36))
+        << ",UDP_DPORT:"   << gist_ss_item(true, BVec(arg_frame.begin() + 36, arg_frame.begin() + 38))
+        << ",UDP_PAYLOAD:" << gist_ss_item(false, none)
+        << ",frame:"       << gist_ss_ipv4(arg_frame)
+        << "}";
+
+    return ss.str();
+}
+
+static void add_read_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    bench_fix &fx = arg_fix;
+
+    arg_cases.push_back({"gist.stringstream_ref", 1, 0, [&fx](uint64_t arg_n)
+    {
+        auto     t0 = chrono::steady_clock::now();
+        FrameUdp frame;
+
+        build_udp(frame, fx.payload.size());
+
+        if (gist_ss_udp(frame.peek_frame()) != frame.gist())
+        {
+            cerr << "FrameBench: stringstream reference does not match gist()" << endl << flush;
+        }
+
+        bench_setup_ns += ns_since(t0);
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) bench_sink += gist_ss_udp(frame.peek_frame()).size();
+    }});
+
+    arg_cases.push_back({"frame.gist", 1, 0, [&fx](uint64_t arg_n)
+    {
+        FrameUdp frame;
+
+        build_udp(frame, fx.payload.size());
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) bench_sink += frame.gist().size();
+    }});
+
+    arg_cases.push_back({"fmt.gist_to", 1, 0, [&fx](uint64_t arg_n)
+    {
+        FrameUdp frame;
+        string   text;
+        FrameFmt fmt(text);
+
+        build_udp(frame, fx.payload.size());
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            fmt.reset();
+            frame.gist_to(fmt);
+            bench_sink += fmt.size();
+        }
+    }});
+
+    arg_cases.push_back({"fmt.json_frame", 1, 0, [&fx](uint64_t arg_n)
+    {
+        char     buf[4096];
+        FrameFmt fmt(buf, sizeof(buf), 64);
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            fmt.reset();
+            fmt.json_frame(fx.views[i % fx.views.size()]);
+            bench_sink += fmt.size();
+        }
+    }});
+
+    arg_cases.push_back({"frame.get_frame_byte", 1, 1514, [&fx](uint64_t arg_n)
+    {
+        Frame   frame;
+        uint8_t byte;
+        uint8_t sum = 0;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.load_frame(fx.frames[3].data(), fx.frames[3].size());
+
+            while (frame.get_frame_byte(byte)) sum += byte;
+        }
+
+        bench_sink += sum;
+    }});
+
+    arg_cases.push_back({"frame.cursor_read", 1, 1514, [&fx](uint64_t arg_n)
+    {
+        Frame    frame;
+        uint32_t word;
+        uint8_t  byte;
+        uint32_t sum = 0;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            frame.load_frame(fx.frames[3].data(), fx.frames[3].size());
+
+            FrameCursor cur = frame.cursor_frame();
+
+            while (cur.read_u32(word)) sum += word;
+            while (cur.read_u8(byte))  sum += byte;
+        }
+
+        bench_sink += sum;
+    }});
+
+    arg_cases.push_back({"decode.single", 1, 0, [&fx](uint64_t arg_n)
+    {
+        frame_info info;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            FrameDecode::decode(fx.views[i % fx.views.size()], info);
+            bench_sink += info.l4_sport;
+        }
+    }});
+
+    arg_cases.push_back({"decode.batch", BenchBatch, 0, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            size_t base = (i * BenchBatch) % (fx.views.size() - BenchBatch);
+
+            bench_sink += FrameDecode::decode_batch(&fx.views[base], BenchBatch, fx.infos.data());
+        }
+    }});
+}
+
+static void add_flow_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    const FlowPath paths[] = {FlowPath::PATH_SCALAR, FlowPath::PATH_AVX2};
+    bench_fix     &fx      = arg_fix;
+
+    arg_cases.push_back({"flowhash.extract_hash", 1, 0, [&fx](uint64_t arg_n)
+    {
+        FlowHash fh;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++) bench_sink += fh.hash(fx.views[i % fx.views.size()].data, fx.views[i % fx.views.size()].caplen);
+    }});
+
+    for (FlowPath path : paths)
+    {
+        if (not FlowHash::has_path(path)) continue;
+
+        string name = (path == FlowPath::PATH_AVX2) ? "flowhash.batch.avx2" : "flowhash.batch.scalar";
+
+        arg_cases.push_back({name, BenchBatch, 0, [&fx, path](uint64_t arg_n)
+        {
+            FlowHash fh(FlowMode::MODE_SYMMETRIC);
+
+            for (uint64_t i = 0 ; i < arg_n ; i++)
+            {
+                size_t base = (i * BenchBatch) % (fx.keys.size() - BenchBatch);
+
+                fh.hash_batch(path, &fx.keys[base], BenchBatch, fx.hashes.data());
+                bench_sink += fx.hashes[0];
+            }
+        }});
+    }
+}
+
+static void add_io_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    const unsigned workers[] = {1, 2, 4, 8};
+    bench_fix     &fx        = arg_fix;
+    double         total     = 0;
+
+    for (BVec &bytes : fx.frames) total += bytes.size();
+
+    arg_cases.push_back({"buf.alloc_1500", 1, 0, [](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            Buf buf(1500);
+
+            bench_sink += buf.capacity();
+        }
+    }});
+
+    arg_cases.push_back({"bvec.alloc_1500", 1, 0, [](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            BVec bytes(1500);
+
+            bench_sink += bytes.size();
+        }
+    }});
+
+    arg_cases.push_back({"wire.tx_rx", 1, 88, [&fx](uint64_t arg_n)
+    {
+        WirePair wire;
+        BVec     bytes;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            wire.end_a().tx_frame(fx.frame.data(), fx.frame.size());
+            wire.end_b().rx_frame(bytes);
+        }
+
+        bench_sink += bytes.size();
+    }});
+
+    arg_cases.push_back({"pcap.read.nic", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            NicPcapFile nic;
+
+            nic.open(fx.pcap);
+
+            while (nic.rx_view(BenchBatch, [](const FrameView &arg_view) { bench_sink += arg_view.caplen; }) > 0) { }
+        }
+    }});
+
+    arg_cases.push_back({"pcap.read.rx_burst", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        rx_burst burst(BenchBatch);
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            NicPcapFile nic;
+
+            nic.open(fx.pcap);
+
+            while (nic.rx_burst(BenchBatch, burst) > 0) bench_sink += burst.slots[0].bytes.size();
+        }
+    }});
+
+    // the per-frame loop rx_burst() and rx_view() replace; it stops short of
+    // the end of the capture, where rx_frame() reports EOF on cerr
+    arg_cases.push_back({"pcap.read.rx_frame", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            Frame frame;
+
+            frame.nic_open_offline(fx.pcap);
+
+            for (unsigned f = 0 ; f < BenchPcapCount and frame.nic_rx_frame() ; f++) bench_sink += frame.peek_frame().size();
+        }
+    }});
+
+    arg_cases.push_back({"pcap.read.pcap_next_ex", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        char                errbuf[PCAP_ERRBUF_SIZE];
+        struct pcap_pkthdr *hdr;
+        const u_char       *pkt;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            pcap_t *handle = pcap_open_offline(fx.pcap.c_str(), errbuf);
+
+            if (handle == NULL) return;
+
+            while (pcap_next_ex(handle, &hdr, &pkt) == 1) bench_sink += hdr->caplen;
+
+            pcap_close(handle);
+        }
+    }});
+
+    arg_cases.push_back({"pcap.read.map", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            PcapMap   map;
+            FrameView view;
+
+            map.open(fx.pcap);
+
+            while (map.next(view)) bench_sink += view.caplen;
+        }
+    }});
+
+    arg_cases.push_back({"pcap.write", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            PcapWriter writer;
+
+            writer.open("/dev/null", true);
+
+            for (FrameView &view : fx.views) writer.write(view);
+
+            writer.close();
+        }
+    }});
+
+    arg_cases.push_back({"pcapng.read.map", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            PcapngMap map;
+            FrameView view;
+            uint32_t  if_id;
+
+            map.open(fx.pcapng);
+
+            while (map.next(view, if_id)) bench_sink += view.caplen;
+        }
+    }});
+
+    arg_cases.push_back({"pcapng.write", BenchPcapCount, total, [&fx](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            PcapngWriter writer;
+
+            writer.open("/dev/null");
+            writer.add_interface("bench");
+
+            for (FrameView &view : fx.views) writer.write(0, view);
+
+            writer.close();
+        }
+    }});
+
+    // libpcap reads pcapng too, when it is built to; skipped otherwise
+    char    errbuf[PCAP_ERRBUF_SIZE];
+    pcap_t *probe = pcap_open_offline(fx.pcapng.c_str(), errbuf);
+
+    if (probe == NULL)
+    {
+        cerr << "FrameBench: libpcap cannot read " << fx.pcapng << ", skipping pcapng.read.pcap_next_ex" << endl << flush;
+    }
+    else
+    {
+        pcap_close(probe);
+
+        arg_cases.push_back({"pcapng.read.pcap_next_ex", BenchPcapCount, total, [&fx](uint64_t arg_n)
+        {
+            char                errbuf[PCAP_ERRBUF_SIZE];
+            struct pcap_pkthdr *hdr;
+            const u_char       *pkt;
+
+            for (uint64_t i = 0 ; i < arg_n ; i++)
+            {
+                pcap_t *handle = pcap_open_offline(fx.pcapng.c_str(), errbuf);
+
+                while (pcap_next_ex(handle, &hdr, &pkt) == 1) bench_sink += hdr->caplen;
+
+                pcap_close(handle);
+            }
+        }});
+    }
+
+    // a whole replay per op; opening the capture, building the pipeline and
+    // starting its threads are not timed.  Each worker decodes and hashes
+    // every frame it is handed.
+    for (unsigned n : workers)
+    {
+        string                       name    = "pipeline.replay.workers_" + to_string(n);
+        shared_ptr<vector<uint64_t>> handled = make_shared<vector<uint64_t>>(n);
+
+        arg_cases.push_back({name, BenchPcapCount, total, [&fx, n, handled](uint64_t arg_n)
+        {
+            FlowHash    fh(FlowMode::MODE_SYMMETRIC);
+            PipeHandler handler = [&fh](unsigned arg_worker, Buf &arg_buf)
+            {
+                frame_info info;
+
+                if (FrameDecode::decode(arg_buf.data(), arg_buf.size(), info)) fh.hash(arg_buf.data(), arg_buf.size());
+            };
+
+            for (uint64_t i = 0 ; i < arg_n ; i++)
+            {
+                auto        t0 = chrono::steady_clock::now();
+                NicPcapFile nic;
+                RxPipeline  pipe(n, 256, PipePolicy::POLICY_BLOCK);
+
+                nic.open(fx.pcap);
+                pipe.set_stop_on_empty(true);
+                pipe.set_flow_hash(fh);
+                pipe.start(nic, handler);
+                bench_setup_ns += ns_since(t0);
+                pipe.wait();
+
+                for (unsigned w = 0 ; w < n ; w++)
+                {
+                    pipe_stats stats;
+
+                    pipe.get_worker_stats(w, stats);
+                    (*handled)[w] = stats.handled;
+                }
+            }
+        }, handled});
+    }
+}
+
+// Transmit on a real interface, lo by default, through a small ring.  A
+// packet socket needs CAP_NET_RAW; without it the nic.tx cases are skipped.
+
+const ring_cfg BenchRingCfg = {1 << 16, 4, RingFrameSize, RingRetireMs};
+
+static void add_tx_cases(vector<bench_case> &arg_cases, bench_fix &arg_fix)
+{
+    bench_fix          &fx    = arg_fix;
+    shared_ptr<NicRing> ring  = make_shared<NicRing>(BenchRingCfg);
+    shared_ptr<NicPcap> pcap  = make_shared<NicPcap>();
+    double              total = 0;
+
+    for (unsigned i = 0 ; i < BenchBatch ; i++) total += fx.frames[i].size();
+
+    if (not ring->open(fx.tx_nic))
+    {
+        cerr << "FrameBench: cannot open " << fx.tx_nic << ", skipping the nic.tx cases" << endl << flush;
+        return;
+    }
+
+    arg_cases.push_back({"nic.tx.per_frame", BenchBatch, total, [&fx, ring](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            for (unsigned f = 0 ; f < BenchBatch ; f++) ring->tx_frame(fx.frames[f].data(), fx.frames[f].size());
+        }
+    }});
+
+    arg_cases.push_back({"nic.tx.queue_flush", BenchBatch, total, [&fx, ring](uint64_t arg_n)
+    {
+        vector<int> results;
+
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            for (unsigned f = 0 ; f < BenchBatch ; f++) ring->tx_queue(fx.frames[f].data(), fx.frames[f].size());
+
+            bench_sink += ring->tx_flush(results);
+        }
+    }});
+
+    if (not pcap->open(fx.tx_nic))
+    {
+        cerr << "FrameBench: cannot open " << fx.tx_nic << " with libpcap, skipping nic.tx.pcap_inject" << endl << flush;
+        return;
+    }
+
+    arg_cases.push_back({"nic.tx.pcap_inject", BenchBatch, total, [&fx, pcap](uint64_t arg_n)
+    {
+        for (uint64_t i = 0 ; i < arg_n ; i++)
+        {
+            for (unsigned f = 0 ; f < BenchBatch ; f++) pcap->tx_frame(fx.frames[f].data(), fx.frames[f].size());
+        }
+    }});
+}
+
+// -- runner --------------------------------------------------------------------
+
+static double percentile(vector<double> &arg_samples, double arg_pct)
+{
+    size_t idx = (size_t)(arg_pct / 100.0 * (arg_samples.size() - 1) + 0.5);
+
+    return arg_samples[idx];
+}
+
+static double time_run(bench_case &arg_case, uint64_t arg_n)
+{
+    auto t0 = chrono::steady_clock::now();
+
+    bench_setup_ns = 0;
+    arg_case.run(arg_n);
+
+    return ns_since(t0) - bench_setup_ns;
+}
+
+// Warm-up also sizes a repetition: ops double until one takes a tenth of
+// arg_rep_ns, then scale to fill it.  Each repetition is timed in BenchSlices
+// slices; the percentiles are over the per-op times of all slices.
+
+static bench_result run_case(bench_case &arg_case, unsigned arg_warm, unsigned arg_reps, double arg_rep_ns)
+{
+    bench_result   res;
+    vector<double> reps;
+    vector<double> slices;
+    uint64_t       ops = 1;
+    uint64_t       slice;
+    uint64_t       allocs;
+    double         ns;
+
+    while (true)
+    {
+        ns = time_run(arg_case, ops);
+
+        if (ns >= arg_rep_ns / 10 or ops >= BenchMaxOps) break;
+
+        ops *= 2;
+    }
+
+    ops   = max<uint64_t>(1, min<uint64_t>(BenchMaxOps, ops * arg_rep_ns / max(ns, 1.0)));
+    slice = max<uint64_t>(1, ops / BenchSlices);
+    ops   = slice * min<uint64_t>(BenchSlices, ops);
+
+    for (unsigned w = 0 ; w < arg_warm ; w++) arg_case.run(ops);
+
+    // no allocations of the harness's own inside the counted window
+    reps.reserve(arg_reps);
+    slices.reserve(arg_reps * BenchSlices);
+
+    allocs = bench_allocs.load(memory_order_relaxed);
+
+    for (unsigned r = 0 ; r < arg_reps ; r++)
+    {
+        double rep = 0;
+
+        for (uint64_t done = 0 ; done < ops ; done += slice)
+        {
+            ns = time_run(arg_case, slice);
+
+            rep += ns;
+            slices.push_back(ns / slice);
+        }
+
+        reps.push_back(rep / ops);
+    }
+
+    allocs = bench_allocs.load(memory_order_relaxed) - allocs;
+
+    sort(reps.begin(), reps.end());
+    sort(slices.begin(), slices.end());
+
+    res.name       = arg_case.name;
+    res.ops        = ops;
+    res.reps       = arg_reps;
+    res.ns_op      = reps[reps.size() / 2];
+    res.ns_min     = reps[0];
+    res.p50        = percentile(slices, 50);
+    res.p90        = percentile(slices, 90);
+    res.p99        = percentile(slices, 99);
+    res.frames_sec = arg_case.frames * 1e9 / res.ns_op;
+    res.bytes_sec  = arg_case.bytes * 1e9 / res.ns_op;
+    res.allocs_op  = (double)allocs / ((double)ops * arg_reps);
+
+    if (arg_case.handled) res.handled = *arg_case.handled;
+
+    return res;
+}
+
+static void write_json(ostream &arg_out, const vector<bench_result> &arg_results, unsigned arg_warm, unsigned arg_reps, double arg_rep_ms)
+{
+    char host[256] = "";
+    auto now       = chrono::system_clock::to_time_t(chrono::system_clock::now());
+
+    gethostname(host, sizeof(host) - 1);
+
+    arg_out << fixed << setprecision(3);
+    arg_out << "{\n";
+    arg_out << "  \"suite\": \"CxxFrames\",\n";
+    arg_out << "  \"version\": \"" << BENCH_VERSION << "\",\n";
+    arg_out << "  \"cflags\": \"" << BENCH_CFLAGS << "\",\n";
+    arg_out << "  \"time\": " << (long)now << ",\n";
+    arg_out << "  \"host\": \"" << host << "\",\n";
+    arg_out << "  \"cksum_path\": \"" << Cksum::get_path_name(Cksum::get_path()) << "\",\n";
+    arg_out << "  \"config\": {\"warmup\": " << arg_warm << ", \"reps\": " << arg_reps << ", \"rep_ms\": " << arg_rep_ms << "},\n";
+    arg_out << "  \"results\": [";
+
+    for (size_t i = 0 ; i < arg_results.size() ; i++)
+    {
+        const bench_result &r = arg_results[i];
+
+        arg_out << (i ? ",\n" : "\n");
+        arg_out << "    {\"name\": \"" << r.name << "\", \"ops\": " << r.ops << ", \"reps\": " << r.reps
+                << ", \"ns_per_op\": " << r.ns_op << ", \"ns_per_op_min\": " << r.ns_min
+                << ", \"p50_ns\": " << r.p50 << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": " << r.p99
+                << ", \"frames_per_sec\": " << r.frames_sec << ", \"bytes_per_sec\": " << r.bytes_sec
+                << ", \"allocs_per_op\": " << r.allocs_op;
+
+        if (not r.handled.empty())
+        {
+            uint64_t hi = *max_element(r.handled.begin(), r.handled.end());
+            uint64_t lo = *min_element(r.handled.begin(), r.handled.end());
+
+            arg_out << ", \"worker_handled\": [";
+
+            for (size_t w = 0 ; w < r.handled.size() ; w++) arg_out << (w ? ", " : "") << r.handled[w];
+
+            arg_out << "], \"worker_max_over_min\": " << (lo ? (double)hi / lo : 0.0);
+        }
+
+        arg_out << "}";
+    }
+
+    arg_out << "\n  ]\n}\n" << flush;
+}
+
+static void usage(void)
+{
+    cerr << "usage: FrameBench [-w warmups] [-r reps] [-t ms] [-f filter] [-o json] [-p pcap] [-i nic] [-l]" << endl
+         << "  -w  warm-up repetitions per case (default 1)" << endl
+         << "  -r  measured repetitions per case (default 5)" << endl
+         << "  -t  target milliseconds per repetition (default 50)" << endl
+         << "  -f  run only cases whose name contains filter" << endl
+         << "  -o  write JSON results to file instead of stdout" << endl
+         << "  -p  scratch capture for the pcap and pipeline cases (default tmp/bench.pcap);" << endl
+         << "      the pcapng cases write the same frames to the same path plus \"ng\"" << endl
+         << "  -i  interface for the nic.tx cases (default lo)" << endl
+         << "  -l  list case names and exit" << endl << flush;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned             warm   = 1;
+    unsigned             reps   = 5;
+    double               rep_ms = 50;
+    string               filter;
+    string               json;
+    bool                 list   = false;
+    bench_fix            fix;
+    vector<bench_case>   cases;
+    vector<bench_result> results;
+    int                  opt;
+
+    fix.pcap   = "tmp/bench.pcap";
+    fix.tx_nic = "lo";
+
+    while ((opt = getopt(argc, argv, "w:r:t:f:o:p:i:lh")) != -1)
+    {
+        switch (opt)
+        {
+            case 'w' : warm       = strtoul(optarg, NULL, 0); break;
+            case 'r' : reps       = strtoul(optarg, NULL, 0); break;
+            case 't' : rep_ms     = strtod(optarg, NULL);     break;
+            case 'f' : filter     = optarg;                   break;
+            case 'o' : json       = optarg;                   break;
+            case 'p' : fix.pcap   = optarg;                   break;
+            case 'i' : fix.tx_nic = optarg;                   break;
+            case 'l' : list       = true;                     break;
+            default  : usage(); exit(1);
+        }
+    }
+
+    if (reps == 0 or rep_ms <= 0)
+    {
+        usage();
+        exit(1);
+    }
+
+    fix.payload  = BVec(46, 0x5A);
+    fix.mtu_ipv4 = BVec(1480, 0x5A);
+    fix.mtu_udp  = BVec(1472, 0x5A);
+    fix.jumbo    = BVec(65536, 0xA5);
+
+    if (not build_pcap(fix))
+    {
+        cerr << "FrameBench: cannot write " << fix.pcap << endl << flush;
+        exit(1);
+    }
+
+    fix.pcapng = fix.pcap + "ng";
+
+    if (not build_pcapng(fix))
+    {
+        cerr << "FrameBench: cannot write " << fix.pcapng << endl << flush;
+        exit(1);
+    }
+
+    if (not list and not check_cksum())
+    {
+        cerr << "FrameBench: checksum self-check failed" << endl << flush;
+        exit(1);
+    }
+
+    fix.frame = fix.frames[0];
+    fix.keys.resize(fix.views.size());
+    fix.hashes.resize(fix.views.size());
+    fix.infos.resize(BenchBatch);
+
+    for (size_t i = 0 ; i < fix.views.size() ; i++) FlowHash::extract(fix.views[i].data, fix.views[i].caplen, fix.keys[i]);
+
+    add_frame_cases(cases, fix);
+    add_cksum_cases(cases, fix);
+    add_read_cases(cases, fix);
+    add_flow_cases(cases, fix);
+    add_io_cases(cases, fix);
+    add_tx_cases(cases, fix);
+
+    for (bench_case &c : cases)
+    {
+        if (not filter.empty() and c.name.find(filter) == string::npos) continue;
+
+        if (list)
+        {
+            cout << c.name << endl;
+            continue;
+        }
+
+        results.push_back(run_case(c, warm, reps, rep_ms * 1e6));
+
+        const bench_result &r = results.back();
+
+        cerr << fixed << setprecision(1) << left << setw(32) << r.name << right
+             << setw(12) << r.ns_op << " ns/op"
+             << setw(10) << r.p99   << " p99"
+             << setw(14) << setprecision(0) << r.frames_sec << " f/s"
+             << setw(8)  << setprecision(2) << r.bytes_sec / 1e9 << " GB/s"
+             << setw(8)  << setprecision(2) << r.allocs_op << " alloc/op" << endl << flush;
+    }
+
+    if (list) exit(0);
+
+    if (json.empty())
+    {
+        write_json(cout, results, warm, reps, rep_ms);
+    }
+    else
+    {
+        ofstream out(json);
+
+        if (not out)
+        {
+            cerr << "FrameBench: cannot write " << json << endl << flush;
+            exit(1);
+        }
+
+        write_json(out, results, warm, reps, rep_ms);
+    }
+
+    exit(0);
+}
@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_CURSOR_H_
+    #define _FRAME_CURSOR_H_
+
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <vector>
+
+    namespace Frames
+    {
+        // Read position over a frame's bytes.  Each call checks the bounds
+        // once for all the bytes it moves and fails without moving if they are
+        // not all there.  Multi-byte reads are big-endian (network order).
+
+        class FrameCursor
+        {
+            private:
+                const uint8_t *base;
+                std::size_t    len;
+                std::size_t    pos;
+
+            public:
+                FrameCursor(void) : base(nullptr), len(0), pos(0) { }
+                FrameCursor(const uint8_t *arg_ptr, std::size_t arg_len) : base(arg_ptr), len(arg_len), pos(0) { }
+                FrameCursor(const std::vector<uint8_t> &arg_bytes) : base(arg_bytes.data()), len(arg_bytes.size()), pos(0) { }
+
+                std::size_t tell(void) const      { return this->pos; }
+                std::size_t size(void) const      { return this->len; }
+                std::size_t remaining(void) const { return this->len - this->pos; }
+                bool at_end(void) const           { return this->pos == this->len; }
+
+                bool seek(std::size_t arg_pos)
+                {
+                    if (arg_pos > this->len) return false;
+
+                    this->pos = arg_pos;
+                    return true;
+                }
+
+                bool skip(std::size_t arg_len)
+                {
+                    if (arg_len > this->len - this->pos) return false;
+
+                    this->pos += arg_len;
+                    return true;
+                }
+
+                bool peek(uint8_t *arg_dst, std::size_t arg_len) const
+                {
+                    if (arg_len > this->len - this->pos) return false;
+
+                    memcpy(arg_dst, this->base + this->pos, arg_len);
+                    return true;
+                }
+
+                bool read(uint8_t *arg_dst, std::size_t arg_len)
+                {
+                    if (not this->peek(arg_dst, arg_len)) return false;
+
+                    this->pos += arg_len;
+                    return true;
+                }
+
+                // hands out a pointer to the next arg_len bytes without copying
+                bool read_span(const uint8_t *&arg_span, std::size_t arg_len)
+                {
+                    if (arg_len > this->len - this->pos) return false;
+
+                    arg_span   = this->base + this->pos;
+                    this->pos += arg_len;
+                    return true;
+                }
+
+                bool read_u8(uint8_t &arg_val)
+                {
+                    if (this->pos >= this->len) return false;
+
+                    arg_val = this->base[this->pos++];
+                    return true;
+                }
+
+                bool read_u16(uint16_t &arg_val)
+                {
+                    const uint8_t *ptr;
+
+                    if (not this->read_span(ptr, 2)) return false;
+
+                    arg_val = (uint16_t)((ptr[0] << 8) | ptr[1]);
+                    return true;
+                }
+
+                bool read_u32(uint32_t &arg_val)
+                {
+                    const uint8_t *ptr;
+
+                    if (not this->read_span(ptr, 4)) return false;
+
+                    arg_val = ((uint32_t)ptr[0] << 24) | ((uint32_t)ptr[1] << 16) | ((uint32_t)ptr[2] << 8) | ptr[3];
+                    return true;
+                }
+
+                bool read_u48(uint64_t &arg_val)
+                {
+                    const uint8_t *ptr;
+
+                    if (not this->read_span(ptr, 6)) return false;
+
+                    arg_val = ((uint64_t)ptr[0] << 40) | ((uint64_t)ptr[1] << 32) | ((uint64_t)ptr[2] << 24) |
+                              ((uint64_t)ptr[3] << 16) | ((uint64_t)ptr[4] << 8)  | ptr[5];
+                    return true;
+                }
+        };
+    }
+#endif
@@ -0,0 +1,226 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <ByteWriter.h>
+#include <FrameEth.h>
+#include <FrameIPv4.h>
+#include <FrameDecode.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    const uint16_t ETYP_ARP_STD = 0x0806;
+
+    static void decode_ipv4(const uint8_t *arg_ptr, size_t arg_len, frame_info &arg_info)
+    {
+        const uint8_t *ip  = arg_ptr + arg_info.l3_off;
+        size_t         rem = arg_len - arg_info.l3_off;
+        unsigned       hlen;
+
+        if (rem < IPV4_HDR_BYTES)
+        {
+            arg_info.flags |= DecodeTrunc;
+            return;
+        }
+
+        // not IPv4 despite the ethertype: nothing more to decode, but not short
+        if ((ip[0] >> 4) != IPV4_VERS) return;
+
+        hlen = (ip[0] & 0x0F) * 4;
+
+        if (hlen < IPV4_HDR_BYTES or hlen > rem)
+        {
+            arg_info.flags |= DecodeTrunc;
+            return;
+        }
+
+        arg_info.flags   |= DecodeIPv4;
+        arg_info.ip_hlen  = hlen;
+        arg_info.ip_tos   = ip[1];
+        arg_info.ip_tlen  = be_load<2>::get(ip + 2);
+        arg_info.ip_id    = be_load<2>::get(ip + 4);
+        arg_info.ip_frag  = be_load<2>::get(ip + 6);
+        arg_info.ip_ttl   = ip[8];
+        arg_info.ip_proto = ip[9];
+        arg_info.ip_sip   = be_load<4>::get(ip + 12);
+        arg_info.ip_dip   = be_load<4>::get(ip + 16);
+        arg_info.l4_off   = arg_info.l3_off + hlen;
+
+        // MF set or a non-zero fragment offset
+        if (arg_info.ip_frag & 0x3FFF) arg_info.flags |= DecodeIPv4Frag;
+
+        // ports are only in the first fragment
+        if (arg_info.ip_frag & 0x1FFF) return;
+
+        if (arg_info.ip_proto == (uint8_t)IPv4Proto::PROTO_UDP or arg_info.ip_proto == (uint8_t)IPv4Proto::PROTO_TCP)
+        {
+            if (arg_info.l4_off + 4u > arg_len)
+            {
+                arg_info.flags |= DecodeTrunc;
+                return;
+            }
+
+            arg_info.flags    |= DecodeL4;
+            arg_info.l4_sport  = be_load<2>::get(arg_ptr + arg_info.l4_off);
+            arg_info.l4_dport  = be_load<2>::get(arg_ptr + arg_info.l4_off + 2);
+        }
+    }
+
+    static void decode_arp(const uint8_t *arg_ptr, size_t arg_len, frame_info &arg_info)
+    {
+        const uint8_t *arp = arg_ptr + arg_info.l3_off;
+
+        if (arg_len - arg_info.l3_off < 8)
+        {
+            arg_info.flags |= DecodeTrunc;
+            return;
+        }
+
+        // Ethernet/IPv4 ARP only: htype 1, ptype 0x0800, hlen 6, plen 4
+        if (be_load<2>::get(arp) != 1 or be_load<2>::get(arp + 2) != 0x0800 or arp[4] != 6 or arp[5] != 4) return;
+
+        if (arg_len - arg_info.l3_off < 28)
+        {
+            arg_info.flags |= DecodeTrunc;
+            return;
+        }
+
+        arg_info.flags   |= DecodeArp;
+        arg_info.arp_op   = be_load<2>::get(arp + 6);
+        arg_info.arp_sip  = be_load<4>::get(arp + 14);
+        arg_info.arp_tip  = be_load<4>::get(arp + 24);
+    }
+
+    static void decode_pause(const uint8_t *arg_ptr, size_t arg_len, frame_info &arg_info)
+    {
+        const uint8_t *ctl = arg_ptr + arg_info.l3_off;
+
+        if (arg_len - arg_info.l3_off < 4)
+        {
+            arg_info.flags |= DecodeTrunc;
+            return;
+        }
+
+        arg_info.flags        |= DecodePause;
+        arg_info.pause_opcode  = be_load<2>::get(ctl);
+        arg_info.pause_quanta  = be_load<2>::get(ctl + 2);
+    }
+
+    bool FrameDecode::decode(const uint8_t *arg_ptr, size_t arg_len, frame_info &arg_info)
+    {
+        unsigned off = 12;
+        uint16_t type;
+
+        arg_info.data      = arg_ptr;
+        arg_info.len       = arg_len;
+        arg_info.flags     = 0;
+        arg_info.tag_count = 0;
+
+        if (arg_len < 14)
+        {
+            arg_info.flags = DecodeTrunc;
+            return false;
+        }
+
+        arg_info.flags = DecodeEth;
+        type           = be_load<2>::get(arg_ptr + off);
+
+        while (type == (uint16_t)EtherType::ETYP_VLAN or type == (uint16_t)EtherType::ETYP_QINQ)
+        {
+            if (off + 6 > arg_len)
+            {
+                arg_info.flags |= DecodeTrunc;
+                return false;
+            }
+
+            if (arg_info.tag_count < DecodeMaxTags)
+            {
+                arg_info.tag_tpid[arg_info.tag_count] = type;
+                arg_info.tag_tci[arg_info.tag_count]  = be_load<2>::get(arg_ptr + off + 2);
+                arg_info.tag_count++;
+            }
+            else
+            {
+                arg_info.flags |= DecodeTagsMore;
+            }
+
+            arg_info.flags |= DecodeTags;
+            off            += 4;
+            type            = be_load<2>::get(arg_ptr + off);
+        }
+
+        arg_info.etype  = type;
+        arg_info.l3_off = off + 2;
+
+        switch (type)
+        {
+            case (uint16_t)EtherType::ETYP_IPV4 : decode_ipv4(arg_ptr, arg_len, arg_info);  break;
+            case ETYP_ARP_STD                   : decode_arp(arg_ptr, arg_len, arg_info);   break;
+            case (uint16_t)EtherType::ETYP_FLOW : decode_pause(arg_ptr, arg_len, arg_info); break;
+            default                             : break;
+        }
+
+        return not (arg_info.flags & DecodeTrunc);
+    }
+
+    bool FrameDecode::decode(const FrameView &arg_view, frame_info &arg_info)
+    {
+        return decode(arg_view.data, arg_view.caplen, arg_info);
+    }
+
+    // The next frame's first two cache lines are prefetched while the
+    // current one is decoded.
+    unsigned FrameDecode::decode_batch(const FrameView *arg_views, unsigned arg_count, frame_info *arg_infos)
+    {
+        unsigned okay = 0;
+
+        for (unsigned i = 0 ; i < arg_count ; ++i)
+        {
+            if (i + 1 < arg_count)
+            {
+                __builtin_prefetch(arg_views[i + 1].data);
+                __builtin_prefetch(arg_views[i + 1].data + 64);
+            }
+
+            if (decode(arg_views[i].data, arg_views[i].caplen, arg_infos[i])) ++okay;
+        }
+
+        return okay;
+    }
+
+    unsigned FrameDecode::decode_batch(const struct rx_burst &arg_burst, frame_info *arg_infos)
+    {
+        unsigned okay = 0;
+
+        for (unsigned i = 0 ; i < arg_burst.count ; ++i)
+        {
+            if (i + 1 < arg_burst.count)
+            {
+                __builtin_prefetch(arg_burst.slots[i + 1].bytes.data());
+                __builtin_prefetch(arg_burst.slots[i + 1].bytes.data() + 64);
+            }
+
+            if (decode(arg_burst.slots[i].bytes.data(), arg_burst.slots[i].bytes.size(), arg_infos[i])) ++okay;
+        }
+
+        return okay;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_DECODE_H_
+    #define _FRAME_DECODE_H_
+
+    #include <Frame.h>
+
+    namespace Frames
+    {
+        const unsigned DecodeMaxTags = 4;
+
+        const uint32_t DecodeEth      = 0x0001;
+        const uint32_t DecodeTags     = 0x0002;
+        const uint32_t DecodeTagsMore = 0x0004;
+        const uint32_t DecodeIPv4     = 0x0008;
+        const uint32_t DecodeIPv4Frag = 0x0010;
+        const uint32_t DecodeL4       = 0x0020;
+        const uint32_t DecodeArp      = 0x0040;
+        const uint32_t DecodePause    = 0x0080;
+        const uint32_t DecodeTrunc    = 0x8000;
+
+        // Offsets are from the start of the frame; multi-byte fields are in
+        // host order.  Only the groups whose Decode* flag is set are valid.
+        // DecodeTrunc means a header was cut short; a header of a kind the
+        // decoder does not handle (non-IPv4 ARP, a bad IP version) is just
+        // left without its flag.
+        struct frame_info
+        {
+            const uint8_t *data;
+            uint32_t       len;
+            uint32_t       flags;
+            uint16_t       etype;
+            uint16_t       l3_off;
+            uint8_t        tag_count;
+            uint16_t       tag_tpid[DecodeMaxTags];
+            uint16_t       tag_tci[DecodeMaxTags];
+
+            uint8_t        ip_hlen;
+            uint8_t        ip_tos;
+            uint8_t        ip_ttl;
+            uint8_t        ip_proto;
+            uint16_t       ip_tlen;
+            uint16_t       ip_id;
+            uint16_t       ip_frag;
+            uint32_t       ip_sip;
+            uint32_t       ip_dip;
+            uint16_t       l4_off;
+            uint16_t       l4_sport;
+            uint16_t       l4_dport;
+
+            uint16_t       arp_op;
+            uint32_t       arp_sip;
+            uint32_t       arp_tip;
+
+            uint16_t       pause_opcode;
+            uint16_t       pause_quanta;
+        };
+
+        // Single-pass decoder: each header is read once, in order, straight
+        // from the received bytes into a frame_info.
+
+        class FrameDecode
+        {
+            public:
+                static bool decode(const uint8_t *arg_ptr, std::size_t arg_len, frame_info &arg_info);
+                static bool decode(const FrameView &arg_view, frame_info &arg_info);
+                static unsigned decode_batch(const FrameView *arg_views, unsigned arg_count, frame_info *arg_infos);
+                static unsigned decode_batch(const struct rx_burst &arg_burst, frame_info *arg_infos);
+        };
+    }
+#endif
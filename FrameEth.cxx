@@ -17,9 +17,10 @@
  *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <FrameFmt.h>
 #include <FrameEth.h>
 
 namespace Frames
@@ -28,21 +29,20 @@ namespace Frames
 
     FrameEth::FrameEth(void) : Frame()
     {
-        spec[ ETH_DMAC        ] = {false, BVec()};
-        spec[ ETH_SMAC        ] = {false, BVec()};
-        spec[ ETH_TYPE_INSERT ] = {false, BVec()};
-        spec[ ETH_TYPE_ENCAP  ] = {false, BVec()};
-        spec[ ETH_PAYLOAD     ] = {false, BVec()};
+        spec[ ETH_DMAC        ].clear();
+        spec[ ETH_SMAC        ].clear();
+        spec[ ETH_TYPE_ENCAP  ].clear();
+        spec_insert             = {false, BVec()};
+        spec_payload            = {false, BVec()};
     }
 
     FrameEth::~FrameEth(void) { }
 
     void FrameEth::get_vec_eth_type(BVec &arg_vec, EtherType arg_et)
     {
-        uint16_t etyp = (uint16_t)arg_et;
+        ByteWriter bw(arg_vec, 2);
 
-        arg_vec.push_back((uint8_t)((etyp & 0xFF00) >> 8));
-        arg_vec.push_back((uint8_t)(etyp & 0x00FF));
+        bw.put_u16((uint16_t)arg_et);
     }
 
     void FrameEth::set_eth_dmac(const BVec &arg_mac)
@@ -53,8 +53,12 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ETH_DMAC].bytes.insert(this->spec[ETH_DMAC].bytes.end(), arg_mac.begin(), arg_mac.end());
-        this->spec[ETH_DMAC].valid = true;
+        this->spec[ETH_DMAC].set(arg_mac.data(), 6);
+    }
+
+    void FrameEth::set_eth_dmac(const uint8_t *arg_mac)
+    {
+        this->spec[ETH_DMAC].set(arg_mac, 6);
     }
 
     void FrameEth::set_eth_smac(const BVec &arg_mac)
@@ -65,15 +69,20 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ETH_SMAC].bytes.insert(this->spec[ETH_SMAC].bytes.end(), arg_mac.begin(), arg_mac.end());
-        this->spec[ETH_SMAC].valid = true;
+        this->spec[ETH_SMAC].set(arg_mac.data(), 6);
+    }
+
+    void FrameEth::set_eth_smac(const uint8_t *arg_mac)
+    {
+        this->spec[ETH_SMAC].set(arg_mac, 6);
     }
 
     void FrameEth::set_eth_type(uint16_t arg_et)
     {
-        this->spec[ETH_TYPE_ENCAP].bytes.push_back((uint8_t)(arg_et >> 8));
-        this->spec[ETH_TYPE_ENCAP].bytes.push_back((uint8_t)(arg_et & 0x00FF));
-        this->spec[ETH_TYPE_ENCAP].valid = true;
+        uint8_t etyp[2];
+
+        be_store<2>::put(etyp, arg_et);
+        this->spec[ETH_TYPE_ENCAP].set(etyp, 2);
     }
 
     void FrameEth::set_eth_type(EtherType arg_et)
@@ -83,8 +92,20 @@ namespace Frames
 
     void FrameEth::set_eth_payload(const BVec &arg_bytes)
     {
-        this->spec[ETH_PAYLOAD].bytes.insert(this->spec[ETH_PAYLOAD].bytes.end(), arg_bytes.begin(), arg_bytes.end());
-        this->spec[ETH_PAYLOAD].valid = true;
+        this->spec_payload.bytes.insert(this->spec_payload.bytes.end(), arg_bytes.begin(), arg_bytes.end());
+        this->spec_payload.valid = true;
+    }
+
+    void FrameEth::set_eth_payload(BVec &&arg_bytes)
+    {
+        if (this->spec_payload.bytes.empty())
+        {
+            this->spec_payload.bytes.swap(arg_bytes);
+            this->spec_payload.valid = true;
+            return;
+        }
+
+        this->set_eth_payload((const BVec &)arg_bytes);
     }
 
     void FrameEth::insert(const BVec &arg_type, const BVec &arg_bytes)
@@ -95,74 +116,93 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[ETH_TYPE_INSERT].bytes.insert(this->spec[ETH_TYPE_INSERT].bytes.end(), arg_type.begin(), arg_type.end());
-        this->spec[ETH_TYPE_INSERT].bytes.insert(this->spec[ETH_TYPE_INSERT].bytes.end(), arg_bytes.begin(), arg_bytes.end());
-        this->spec[ETH_TYPE_INSERT].valid = true;
+        // tags stack without bound, so this lives beside the inline fields
+        this->spec_insert.bytes.insert(this->spec_insert.bytes.end(), arg_type.begin(), arg_type.end());
+        this->spec_insert.bytes.insert(this->spec_insert.bytes.end(), arg_bytes.begin(), arg_bytes.end());
+        this->spec_insert.valid = true;
     }
 
-    void FrameEth::encapsulate(void)
+    size_t FrameEth::eth_hdr_len(void)
     {
-        bool   okay   = true;
-        string errmsg = "[ERR] encapsulate(): cannot encapsulate with an invalid";
-        BVec   bytes;
+        size_t len = 14;
+
+        if (this->spec_insert.valid)
+        {
+            len += this->spec_insert.bytes.size();
+        }
+
+        return len;
+    }
+
+    void FrameEth::encap_eth(HeadBuf &arg_buf, bool arg_payload_valid)
+    {
+        bool     okay   = true;
+        string   errmsg = "[ERR] encapsulate(): cannot encapsulate with an invalid";
+        item    &insert = this->spec_insert;
+        uint8_t *ptr;
 
         if (not this->spec[ETH_DMAC].valid)       okay = false;
         if (not this->spec[ETH_SMAC].valid)       okay = false;
         if (not this->spec[ETH_TYPE_ENCAP].valid) okay = false;
-        if (not this->spec[ETH_PAYLOAD].valid)    okay = false;
+        if (not arg_payload_valid)                okay = false;
 
         if (not this->spec[ETH_DMAC].valid)       cerr << errmsg << " dmac"         << endl << flush;
         if (not this->spec[ETH_SMAC].valid)       cerr << errmsg << " smac"         << endl << flush;
         if (not this->spec[ETH_TYPE_ENCAP].valid) cerr << errmsg << " payload type" << endl << flush;
-        if (not this->spec[ETH_PAYLOAD].valid)    cerr << errmsg << " payload"      << endl << flush;
+        if (not arg_payload_valid)                cerr << errmsg << " payload"      << endl << flush;
 
         if (not okay) exit(1);
 
-        bytes.insert(bytes.end(), this->spec[ETH_DMAC].bytes.begin(), this->spec[ETH_DMAC].bytes.end());
-        bytes.insert(bytes.end(), this->spec[ETH_SMAC].bytes.begin(), this->spec[ETH_SMAC].bytes.end());
+        ptr = arg_buf.prepend(2);
+        memcpy(ptr, this->spec[ETH_TYPE_ENCAP].bytes, 2);
 
-        if (this->spec[ETH_TYPE_INSERT].valid)
+        if (insert.valid)
         {
-            bytes.insert(bytes.end(), this->spec[ETH_TYPE_INSERT].bytes.begin(), this->spec[ETH_TYPE_INSERT].bytes.end());
+            ptr = arg_buf.prepend(insert.bytes.size());
+            memcpy(ptr, insert.bytes.data(), insert.bytes.size());
         }
 
-        bytes.insert(bytes.end(), this->spec[ETH_TYPE_ENCAP].bytes.begin(), this->spec[ETH_TYPE_ENCAP].bytes.end());
-        bytes.insert(bytes.end(), this->spec[ETH_PAYLOAD].bytes.begin(), this->spec[ETH_PAYLOAD].bytes.end());
+        ptr = arg_buf.prepend(12);
+        memcpy(ptr + 0, this->spec[ETH_DMAC].bytes, 6);
+        memcpy(ptr + 6, this->spec[ETH_SMAC].bytes, 6);
+
+        give_frame(arg_buf.release());
 
-        give_frame(move(bytes));
+        this->spec[ETH_DMAC].clear();
+        this->spec[ETH_SMAC].clear();
+        this->spec[ETH_TYPE_ENCAP].clear();
 
-        this->spec[ETH_DMAC].valid        = false;
-        this->spec[ETH_SMAC].valid        = false;
-        this->spec[ETH_TYPE_ENCAP].valid  = false;
-        this->spec[ETH_TYPE_INSERT].valid = false;
-        this->spec[ETH_PAYLOAD].valid     = false;
+        this->spec_insert.valid = false;
+        this->spec_insert.bytes.clear();
 
-        this->spec[ETH_DMAC].bytes.clear();
-        this->spec[ETH_SMAC].bytes.clear();
-        this->spec[ETH_TYPE_ENCAP].bytes.clear();
-        this->spec[ETH_TYPE_INSERT].bytes.clear();
-        this->spec[ETH_PAYLOAD].bytes.clear();
+        this->spec_payload.valid = false;
+        this->spec_payload.bytes.clear();
     }
 
-    string FrameEth::gist(void)
+    void FrameEth::encapsulate(void)
     {
-        stringstream ss;
+        item    &payload = this->spec_payload;
+        HeadBuf  buf(this->eth_hdr_len(), payload.bytes.size());
 
-        ss  << "{spec:"
-            << "ETH_DMAC:" << gist_item(this->spec[ETH_DMAC])
-            << ",ETH_SMAC:" << gist_item(this->spec[ETH_SMAC]);
+        buf.append(payload.bytes);
 
-        if (this->spec[ETH_TYPE_INSERT].valid)
-        {
-            ss << ",ETH_TYPE_INSERT:" << gist_item(this->spec[ETH_TYPE_INSERT]);
-        }
+        this->encap_eth(buf, payload.valid);
+    }
 
+    void FrameEth::gist_to(FrameFmt &arg_fmt)
+    {
+        arg_fmt.put("{spec:");
+        arg_fmt.put("ETH_DMAC:");         arg_fmt.gist_field(this->spec[ETH_DMAC]);
+        arg_fmt.put(",ETH_SMAC:");        arg_fmt.gist_field(this->spec[ETH_SMAC]);
 
-        ss  << ",ETH_TYPE_ENCAP:" << gist_item(this->spec[ETH_TYPE_ENCAP])
-            << ",ETH_PAYLOAD:" << gist_item(this->spec[ETH_PAYLOAD])
-            << ",frame:" << Frame::gist()
-            << "}";
+        if (this->spec_insert.valid)
+        {
+            arg_fmt.put(",ETH_TYPE_INSERT:"); arg_fmt.gist_item(this->spec_insert);
+        }
 
-        return ss.str();
+        arg_fmt.put(",ETH_TYPE_ENCAP:");  arg_fmt.gist_field(this->spec[ETH_TYPE_ENCAP]);
+        arg_fmt.put(",ETH_PAYLOAD:");     arg_fmt.gist_item(this->spec_payload);
+        arg_fmt.put(",frame:");           Frame::gist_to(arg_fmt);
+        arg_fmt.put("}");
     }
 }
@@ -21,7 +21,8 @@
     #define _FRAME_ETH_H_
     
     #include <Frame.h>
-    #include <unordered_map>
+    #include <HeadBuf.h>
+    #include <array>
 
     namespace Frames
     {
@@ -46,7 +47,13 @@
         class FrameEth : public Frame
         {
             private:
-                std::unordered_map<EthField, item> spec;
+                std::array<field, ETH_PAYLOAD> spec;
+                item                           spec_insert;
+                item                           spec_payload;
+
+            protected:
+                std::size_t eth_hdr_len(void);
+                void encap_eth(HeadBuf &arg_buf, bool arg_payload_valid = true);
 
             public:
                 FrameEth(void);
@@ -54,13 +61,16 @@
 
                 void get_vec_eth_type(BVec &arg_vec, EtherType arg_et);
                 void set_eth_dmac(const BVec &arg_mac);
+                void set_eth_dmac(const uint8_t *arg_mac);
                 void set_eth_smac(const BVec &arg_mac);
+                void set_eth_smac(const uint8_t *arg_mac);
                 void set_eth_type(uint16_t arg_et);
                 void set_eth_type(EtherType arg_et);
                 void set_eth_payload(const BVec &arg_bytes);
+                void set_eth_payload(BVec &&arg_bytes);
                 void insert(const BVec &arg_type, const BVec &arg_bytes);
                 virtual void encapsulate(void);
-                virtual std::string gist(void);
+                virtual void gist_to(FrameFmt &arg_fmt);
         };
     }
 #endif
@@ -0,0 +1,326 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <ctime>
+#include <FrameView.h>
+#include <FrameDecode.h>
+#include <FrameFmt.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    static const char HexPairs[] =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+    FrameFmt::FrameFmt(char *arg_buf, size_t arg_cap, size_t arg_max_bytes)
+    {
+        this->out       = arg_buf;
+        this->cap       = arg_cap;
+        this->pos       = 0;
+        this->str       = nullptr;
+        this->max_bytes = arg_max_bytes;
+        this->clipped   = false;
+    }
+
+    FrameFmt::FrameFmt(string &arg_str, size_t arg_max_bytes)
+    {
+        this->out       = nullptr;
+        this->cap       = 0;
+        this->pos       = 0;
+        this->str       = &arg_str;
+        this->max_bytes = arg_max_bytes;
+        this->clipped   = false;
+    }
+
+    void FrameFmt::reset(void)
+    {
+        this->pos     = 0;
+        this->clipped = false;
+
+        if (this->str) this->str->clear();
+    }
+
+    const char * FrameFmt::data(void) const
+    {
+        return this->str ? this->str->data() : this->out;
+    }
+
+    size_t FrameFmt::size(void) const
+    {
+        return this->str ? this->str->size() : this->pos;
+    }
+
+    bool FrameFmt::overflowed(void) const
+    {
+        return this->clipped;
+    }
+
+    void FrameFmt::put(const char *arg_text, size_t arg_len)
+    {
+        if (this->str)
+        {
+            this->str->append(arg_text, arg_len);
+            return;
+        }
+
+        if (arg_len > this->cap - this->pos)
+        {
+            arg_len       = this->cap - this->pos;
+            this->clipped = true;
+        }
+
+        memcpy(this->out + this->pos, arg_text, arg_len);
+        this->pos += arg_len;
+    }
+
+    void FrameFmt::put_bool(bool arg_val)
+    {
+        if (arg_val) this->put("true");
+        else         this->put("false");
+    }
+
+    void FrameFmt::put_dec(uint64_t arg_val)
+    {
+        char   text[20];
+        size_t at = sizeof(text);
+
+        do
+        {
+            text[--at] = '0' + (arg_val % 10);
+            arg_val   /= 10;
+        } while (arg_val);
+
+        this->put(text + at, sizeof(text) - at);
+    }
+
+    void FrameFmt::put_hex(uint64_t arg_val, unsigned arg_digits)
+    {
+        char text[16];
+
+        if (arg_digits > 16) arg_digits = 16;
+
+        for (unsigned i = 0 ; i < arg_digits ; ++i)
+        {
+            text[arg_digits - 1 - i] = HexPairs[(arg_val & 0x0F) * 2 + 1];
+            arg_val >>= 4;
+        }
+
+        this->put(text, arg_digits);
+    }
+
+    void FrameFmt::put_hex_bytes(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        char   text[128];
+        size_t fill = 0;
+
+        for (size_t i = 0 ; i < arg_len ; ++i)
+        {
+            memcpy(text + fill, HexPairs + arg_bytes[i] * 2, 2);
+            fill += 2;
+
+            if (fill == sizeof(text))
+            {
+                this->put(text, fill);
+                fill = 0;
+            }
+        }
+
+        this->put(text, fill);
+    }
+
+    // same text as Frame::gist_bytes(): bytes:{0x01,0x02} or bytes:{empty}
+    void FrameFmt::gist_bytes(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        char   text[125];
+        size_t fill = 0;
+        size_t skip = 1;
+        size_t show = arg_len;
+
+        if (arg_len == 0)
+        {
+            this->put("bytes:{empty}");
+            return;
+        }
+
+        if (this->max_bytes and show > this->max_bytes) show = this->max_bytes;
+
+        this->put("bytes:{");
+
+        // each byte is ",0xHH"; the comma in front of the first is skipped
+        for (size_t i = 0 ; i < show ; ++i)
+        {
+            memcpy(text + fill, ",0x", 3);
+            memcpy(text + fill + 3, HexPairs + arg_bytes[i] * 2, 2);
+            fill += 5;
+
+            if (fill == sizeof(text) or i + 1 == show)
+            {
+                this->put(text + skip, fill - skip);
+                fill = 0;
+                skip = 0;
+            }
+        }
+
+        if (show < arg_len) this->put(",...");
+
+        this->put("}");
+    }
+
+    void FrameFmt::gist_field(bool arg_valid, const uint8_t *arg_bytes, size_t arg_len)
+    {
+        this->put("{valid:");
+        this->put_bool(arg_valid);
+        this->put(",");
+        this->gist_bytes(arg_bytes, arg_len);
+        this->put("}");
+    }
+
+    void FrameFmt::gist_field(const field &arg_field)
+    {
+        this->gist_field(arg_field.valid, arg_field.bytes, arg_field.size);
+    }
+
+    void FrameFmt::gist_item(const item &arg_item)
+    {
+        this->gist_field(arg_item.valid, arg_item.bytes.data(), arg_item.bytes.size());
+    }
+
+    static void put_ipv4(FrameFmt &arg_fmt, uint32_t arg_ip)
+    {
+        arg_fmt.put("\"");
+        arg_fmt.put_dec((arg_ip >> 24) & 0xFF);
+        arg_fmt.put(".");
+        arg_fmt.put_dec((arg_ip >> 16) & 0xFF);
+        arg_fmt.put(".");
+        arg_fmt.put_dec((arg_ip >> 8) & 0xFF);
+        arg_fmt.put(".");
+        arg_fmt.put_dec(arg_ip & 0xFF);
+        arg_fmt.put("\"");
+    }
+
+    // One JSON object per line: capture time, lengths, the decoded header
+    // fields and the (possibly truncated) bytes in hex.
+    void FrameFmt::json_frame(const uint8_t *arg_bytes, size_t arg_caplen, size_t arg_len, const struct timespec &arg_ts)
+    {
+        frame_info info;
+        size_t     show = arg_caplen;
+        char       nsec[9];
+        long       ns   = arg_ts.tv_nsec;
+
+        if (this->max_bytes and show > this->max_bytes) show = this->max_bytes;
+
+        for (int i = 8 ; i >= 0 ; --i)
+        {
+            nsec[i] = '0' + (ns % 10);
+            ns     /= 10;
+        }
+
+        this->put("{\"ts\":");
+        this->put_dec(arg_ts.tv_sec);
+        this->put(".");
+        this->put(nsec, 9);
+        this->put(",\"caplen\":");
+        this->put_dec(arg_caplen);
+        this->put(",\"len\":");
+        this->put_dec(arg_len);
+
+        FrameDecode::decode(arg_bytes, arg_caplen, info);
+
+        if (info.flags & DecodeEth)
+        {
+            this->put(",\"dmac\":\"");
+            this->put_hex_bytes(arg_bytes + 0, 6);
+            this->put("\",\"smac\":\"");
+            this->put_hex_bytes(arg_bytes + 6, 6);
+            this->put("\",\"etype\":");
+            this->put_dec(info.etype);
+        }
+
+        if (info.tag_count)
+        {
+            this->put(",\"tags\":[");
+
+            for (unsigned i = 0 ; i < info.tag_count ; ++i)
+            {
+                if (i) this->put(",");
+                this->put_dec(info.tag_tci[i]);
+            }
+
+            this->put("]");
+        }
+
+        if (info.flags & DecodeIPv4)
+        {
+            this->put(",\"sip\":");
+            put_ipv4(*this, info.ip_sip);
+            this->put(",\"dip\":");
+            put_ipv4(*this, info.ip_dip);
+            this->put(",\"proto\":");
+            this->put_dec(info.ip_proto);
+            this->put(",\"ttl\":");
+            this->put_dec(info.ip_ttl);
+        }
+
+        if (info.flags & DecodeL4)
+        {
+            this->put(",\"sport\":");
+            this->put_dec(info.l4_sport);
+            this->put(",\"dport\":");
+            this->put_dec(info.l4_dport);
+        }
+
+        if (info.flags & DecodeArp)
+        {
+            this->put(",\"arp_op\":");
+            this->put_dec(info.arp_op);
+            this->put(",\"arp_sip\":");
+            put_ipv4(*this, info.arp_sip);
+            this->put(",\"arp_tip\":");
+            put_ipv4(*this, info.arp_tip);
+        }
+
+        if (info.flags & DecodePause)
+        {
+            this->put(",\"quanta\":");
+            this->put_dec(info.pause_quanta);
+        }
+
+        this->put(",\"bytes\":\"");
+        this->put_hex_bytes(arg_bytes, show);
+        this->put("\"");
+
+        if (show < arg_caplen) this->put(",\"trunc\":true");
+
+        this->put("}\n");
+    }
+
+    void FrameFmt::json_frame(const FrameView &arg_view)
+    {
+        this->json_frame(arg_view.data, arg_view.caplen, arg_view.len, arg_view.ts);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_FMT_H_
+    #define _FRAME_FMT_H_
+
+    #include <Frame.h>
+
+    namespace Frames
+    {
+        // Table-driven text formatter.  Output goes either into a fixed
+        // caller buffer, clipped at its capacity (overflowed() reports the
+        // clip), or appended to a caller string that is reused across frames.
+        // arg_max_bytes, when non-zero, limits every byte dump to that many
+        // bytes; a clipped dump ends in "..." (gist) or sets "trunc" (JSON).
+
+        class FrameFmt
+        {
+            private:
+                char        *out;
+                std::size_t  cap;
+                std::size_t  pos;
+                std::string *str;
+                std::size_t  max_bytes;
+                bool         clipped;
+
+            public:
+                FrameFmt(char *arg_buf, std::size_t arg_cap, std::size_t arg_max_bytes = 0);
+                FrameFmt(std::string &arg_str, std::size_t arg_max_bytes = 0);
+
+                void reset(void);
+                const char * data(void) const;
+                std::size_t size(void) const;
+                bool overflowed(void) const;
+
+                void put(const char *arg_text, std::size_t arg_len);
+
+                template <std::size_t N>
+                void put(const char (&arg_text)[N])
+                {
+                    this->put(arg_text, N - 1);
+                }
+
+                void put_bool(bool arg_val);
+                void put_dec(uint64_t arg_val);
+                void put_hex(uint64_t arg_val, unsigned arg_digits);
+                void put_hex_bytes(const uint8_t *arg_bytes, std::size_t arg_len);
+
+                void gist_bytes(const uint8_t *arg_bytes, std::size_t arg_len);
+                void gist_field(bool arg_valid, const uint8_t *arg_bytes, std::size_t arg_len);
+                void gist_field(const field &arg_field);
+                void gist_item(const item &arg_item);
+                void json_frame(const uint8_t *arg_bytes, std::size_t arg_caplen, std::size_t arg_len, const struct timespec &arg_ts);
+                void json_frame(const FrameView &arg_view);
+        };
+    }
+#endif
@@ -19,7 +19,10 @@
 
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <Cksum.h>
+#include <FrameFmt.h>
 #include <FrameIPv4.h>
 
 namespace Frames
@@ -28,10 +31,10 @@ namespace Frames
 
     FrameIPv4::FrameIPv4(void) : FrameEth()
     {
-        this->spec[ IPV4_PROTO   ] = {false, BVec()};
-        this->spec[ IPV4_SIP     ] = {false, BVec()};
-        this->spec[ IPV4_DIP     ] = {false, BVec()};
-        this->spec[ IPV4_PAYLOAD ] = {false, BVec()};
+        this->spec[ IPV4_PROTO ].clear();
+        this->spec[ IPV4_SIP   ].clear();
+        this->spec[ IPV4_DIP   ].clear();
+        this->spec_payload         = {false, BVec()};
         this->checksum             = 0;
     }
 
@@ -39,8 +42,9 @@ namespace Frames
 
     void FrameIPv4::set_ipv4_proto(const IPv4Proto arg_proto)
     {
-        this->spec[IPV4_PROTO].bytes.push_back((uint8_t)(arg_proto));
-        this->spec[IPV4_PROTO].valid = true;
+        uint8_t proto = (uint8_t)(arg_proto);
+
+        this->spec[IPV4_PROTO].set(&proto, 1);
     }
 
     void FrameIPv4::set_ipv4_sip(const BVec &arg_sip)
@@ -51,8 +55,7 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[IPV4_SIP].bytes.insert(this->spec[IPV4_SIP].bytes.end(), arg_sip.begin(), arg_sip.end());
-        this->spec[IPV4_SIP].valid = true;
+        this->spec[IPV4_SIP].set(arg_sip.data(), 4);
     }
 
     void FrameIPv4::set_ipv4_dip(const BVec &arg_dip)
@@ -63,48 +66,50 @@ namespace Frames
             exit(1);
         }
 
-        this->spec[IPV4_DIP].bytes.insert(this->spec[IPV4_DIP].bytes.end(), arg_dip.begin(), arg_dip.end());
-        this->spec[IPV4_DIP].valid = true;
+        this->spec[IPV4_DIP].set(arg_dip.data(), 4);
     }
 
     void FrameIPv4::set_ipv4_payload(const BVec &arg_pyld)
     {
-        this->spec[IPV4_PAYLOAD].bytes.insert(this->spec[IPV4_PAYLOAD].bytes.end(), arg_pyld.begin(), arg_pyld.end());
-        this->spec[IPV4_PAYLOAD].valid = true;
+        this->spec_payload.bytes.insert(this->spec_payload.bytes.end(), arg_pyld.begin(), arg_pyld.end());
+        this->spec_payload.valid = true;
     }
 
-    uint32_t FrameIPv4::cksum_calc(const BVec &arg_hdr)
+    void FrameIPv4::set_ipv4_payload(BVec &&arg_pyld)
     {
-        uint32_t word  = 0;
-        uint32_t accum = 0;
-        bool     mod0  = true;
-
-        for (auto it = arg_hdr.begin() ; it != arg_hdr.end() ; ++it)
+        if (this->spec_payload.bytes.empty())
         {
-            if (mod0)
-            {
-                word = (*it) << 8;
-            }
-            else
-            {
-                word  = word + (*it);
-                accum = accum + word;
-            }
-
-            mod0 = not mod0;
+            this->spec_payload.bytes.swap(arg_pyld);
+            this->spec_payload.valid = true;
+            return;
         }
 
-        return (accum & 0xFFFF) + (accum >> 16);
+        this->set_ipv4_payload((const BVec &)arg_pyld);
+    }
+
+    uint32_t FrameIPv4::cksum_calc(const BVec &arg_hdr)
+    {
+        return this->cksum_calc(arg_hdr.data(), arg_hdr.size());
+    }
+
+    uint32_t FrameIPv4::cksum_calc(const uint8_t *arg_hdr, size_t arg_len)
+    {
+        return Cksum::sum(arg_hdr, arg_len);
     }
 
     void FrameIPv4::cksum_gen(BVec &arg_hdr)
+    {
+        this->cksum_gen(arg_hdr.data(), arg_hdr.size());
+    }
+
+    void FrameIPv4::cksum_gen(uint8_t *arg_hdr, size_t arg_len)
     {
         uint32_t accum;
             
         accum          = 0;
         arg_hdr[10]    = 0;
         arg_hdr[11]    = 0;
-        accum          = this->cksum_calc(arg_hdr);
+        accum          = this->cksum_calc(arg_hdr, arg_len);
         accum          = ~accum;
         arg_hdr[10]    = (accum & 0x0000FF00) >> 8;
         arg_hdr[11]    = accum & 0x000000FF;
@@ -113,19 +118,63 @@ namespace Frames
 
     bool FrameIPv4::cksum_chk(const BVec &arg_hdr)
     {
-        uint32_t accum = this->cksum_calc(arg_hdr);
+        return this->cksum_chk(arg_hdr.data(), arg_hdr.size());
+    }
+
+    bool FrameIPv4::cksum_chk(const uint8_t *arg_hdr, size_t arg_len)
+    {
+        uint32_t accum = this->cksum_calc(arg_hdr, arg_len);
 
         if (accum == 0xFFFF) return true;
         return false;
     }
 
+    // RFC 1624 eqn. 3: HC' = ~(~HC + ~m + m'), summed over each 16-bit word
+    // that changed.  arg_old/arg_new hold arg_len bytes (even) of the same
+    // word-aligned span before and after the change.
+    uint16_t FrameIPv4::cksum_adjust(uint16_t arg_cksum, const uint8_t *arg_old, const uint8_t *arg_new, size_t arg_len)
+    {
+        uint32_t accum = (uint16_t)(~arg_cksum);
 
-    void FrameIPv4::encapsulate(void)
+        for (size_t i = 0 ; i + 1 < arg_len ; i += 2)
+        {
+            accum += (uint16_t)(~((arg_old[i] << 8) + arg_old[i + 1]));
+            accum += (arg_new[i] << 8) + arg_new[i + 1];
+        }
+
+        accum = (accum & 0xFFFF) + (accum >> 16);
+        accum = (accum & 0xFFFF) + (accum >> 16);
+
+        return (uint16_t)(~accum);
+    }
+
+
+    size_t FrameIPv4::ipv4_hdr_len(void)
+    {
+        return this->eth_hdr_len() + IPV4_HDR_BYTES;
+    }
+
+    // sum of the TCP/UDP pseudo-header for an upper-layer length of arg_len
+    uint16_t FrameIPv4::ipv4_pseudo_sum(size_t arg_len)
+    {
+        uint8_t    phdr[12];
+        ByteWriter bw(phdr, sizeof(phdr));
+
+        bw.put_bytes(this->spec[IPV4_SIP].bytes, 4);
+        bw.put_bytes(this->spec[IPV4_DIP].bytes, 4);
+        bw.put_u8(0x00);
+        bw.put_bytes(this->spec[IPV4_PROTO].bytes, 1);
+        bw.put_u16(arg_len);
+
+        return Cksum::sum(phdr, sizeof(phdr));
+    }
+
+    void FrameIPv4::encap_ipv4(HeadBuf &arg_buf)
     {
         bool     okay    = true;
         string   errmsg  = "[ERR] encapsulate(): cannot encapsulate with an invalid";
-        uint32_t tlength = this->spec[IPV4_PAYLOAD].bytes.size() + (IPV4_HLEN * 4);
-        BVec     bytes;
+        uint32_t tlength = arg_buf.size() + IPV4_HDR_BYTES;
+        uint8_t *hdr;
 
         if (not this->spec[ IPV4_PROTO ].valid) okay = false;
         if (not this->spec[ IPV4_SIP   ].valid) okay = false;
@@ -140,54 +189,54 @@ namespace Frames
 
         if (not okay) exit(1);
 
-        bytes.push_back((IPV4_VERS << 4) + IPV4_HLEN);
-        bytes.push_back(IPV4_TOS);
-        bytes.push_back(tlength >> 8);
-        bytes.push_back(tlength & 0x00FF);
-        bytes.push_back(IPV4_FRAG[0]);
-        bytes.push_back(IPV4_FRAG[1]);
-        bytes.push_back(IPV4_FRAG[2]);
-        bytes.push_back(IPV4_FRAG[3]);
-        bytes.push_back(IPV4_TTL);
-        bytes.push_back(this->spec[IPV4_PROTO].bytes[0]);
-        bytes.push_back(0x00);
-        bytes.push_back(0x00);
-        bytes.push_back(this->spec[IPV4_SIP].bytes[0]);
-        bytes.push_back(this->spec[IPV4_SIP].bytes[1]);
-        bytes.push_back(this->spec[IPV4_SIP].bytes[2]);
-        bytes.push_back(this->spec[IPV4_SIP].bytes[3]);
-        bytes.push_back(this->spec[IPV4_DIP].bytes[0]);
-        bytes.push_back(this->spec[IPV4_DIP].bytes[1]);
-        bytes.push_back(this->spec[IPV4_DIP].bytes[2]);
-        bytes.push_back(this->spec[IPV4_DIP].bytes[3]);
-
-        this->cksum_gen(bytes);
-
-        if (not this->cksum_chk(bytes))
+        this->set_eth_type(EtherType::ETYP_IPV4);
+
+        hdr = arg_buf.prepend(IPV4_HDR_BYTES);
+
+        ByteWriter bw(hdr, IPV4_HDR_BYTES);
+
+        bw.put_u8((IPV4_VERS << 4) + IPV4_HLEN);
+        bw.put_u8(IPV4_TOS);
+        bw.put_u16(tlength);
+        bw.put_bytes(IPV4_FRAG, 4);
+        bw.put_u8(IPV4_TTL);
+        bw.put_bytes(this->spec[IPV4_PROTO].bytes, 1);
+        bw.put_u16(0x0000);
+        bw.put_bytes(this->spec[IPV4_SIP].bytes, 4);
+        bw.put_bytes(this->spec[IPV4_DIP].bytes, 4);
+
+        this->cksum_gen(hdr, IPV4_HDR_BYTES);
+
+        if (not this->cksum_chk(hdr, IPV4_HDR_BYTES))
         {
             cerr << errmsg << " header checksum 0x" << setfill('0') << setw(4) << hex << this->checksum << endl << flush;
             exit(1);
         }
 
-        bytes.insert(bytes.end(), this->spec[IPV4_PAYLOAD].bytes.begin(), this->spec[IPV4_PAYLOAD].bytes.end());
-
-        this->set_eth_type(EtherType::ETYP_IPV4);
-        this->set_eth_payload(bytes);
-        FrameEth::encapsulate();
+        this->encap_eth(arg_buf);
     }
 
-    string FrameIPv4::gist(void)
+    void FrameIPv4::encapsulate(void)
     {
-        stringstream ss;
+        BVec &payload = this->spec_payload.bytes;
+
+        // the payload is written once; the IPv4 and Ethernet headers are
+        // prepended in front of it
+        HeadBuf buf(this->ipv4_hdr_len(), payload.size());
 
-        ss  << "{spec:"
-            << ",IPV4_PROTO:"   << gist_item(this->spec[IPV4_PROTO])
-            << ",IPV4_SIP:"     << gist_item(this->spec[IPV4_SIP])
-            << ",IPV4_DIP:"     << gist_item(this->spec[IPV4_DIP])
-            << ",IPV4_PAYLOAD:" << gist_item(this->spec[IPV4_PAYLOAD])
-            << ",frame:"        << FrameEth::gist()
-            << "}";
+        buf.append(payload);
 
-        return ss.str();
+        this->encap_ipv4(buf);
+    }
+
+    void FrameIPv4::gist_to(FrameFmt &arg_fmt)
+    {
+        arg_fmt.put("{spec:");
+        arg_fmt.put(",IPV4_PROTO:");   arg_fmt.gist_field(this->spec[IPV4_PROTO]);
+        arg_fmt.put(",IPV4_SIP:");     arg_fmt.gist_field(this->spec[IPV4_SIP]);
+        arg_fmt.put(",IPV4_DIP:");     arg_fmt.gist_field(this->spec[IPV4_DIP]);
+        arg_fmt.put(",IPV4_PAYLOAD:"); arg_fmt.gist_item(this->spec_payload);
+        arg_fmt.put(",frame:");        FrameEth::gist_to(arg_fmt);
+        arg_fmt.put("}");
     }
 }
@@ -39,12 +39,19 @@
         const uint8_t IPV4_TOS    = 0x00;
         const uint8_t IPV4_FRAG[] = {0x00, 0x00, 0x40, 0x00};
         const uint8_t IPV4_TTL    = 0x20;
+        const unsigned IPV4_HDR_BYTES = IPV4_HLEN * 4;
 
         class FrameIPv4 : public FrameEth
         {
             private:
-                std::unordered_map<IPv4Field, item> spec;
-                uint16_t                            checksum;
+                std::array<field, IPV4_PAYLOAD> spec;
+                item                            spec_payload;
+                uint16_t                        checksum;
+
+            protected:
+                std::size_t ipv4_hdr_len(void);
+                uint16_t ipv4_pseudo_sum(std::size_t arg_len);
+                void encap_ipv4(HeadBuf &arg_buf);
 
             public:
                 FrameIPv4(void);
@@ -54,13 +61,18 @@
                 void set_ipv4_sip(const BVec &arg_sip);
                 void set_ipv4_dip(const BVec &arg_dip);
                 void set_ipv4_payload(const BVec &arg_payload);
+                void set_ipv4_payload(BVec &&arg_payload);
 
                 uint32_t cksum_calc(const BVec &arg_hdr);
+                uint32_t cksum_calc(const uint8_t *arg_hdr, std::size_t arg_len);
                 void cksum_gen(BVec &arg_hdr);
+                void cksum_gen(uint8_t *arg_hdr, std::size_t arg_len);
                 bool cksum_chk(const BVec &arg_hdr);
+                bool cksum_chk(const uint8_t *arg_hdr, std::size_t arg_len);
+                static uint16_t cksum_adjust(uint16_t arg_cksum, const uint8_t *arg_old, const uint8_t *arg_new, std::size_t arg_len);
 
                 virtual void encapsulate(void);
-                virtual std::string gist(void);
+                virtual void gist_to(FrameFmt &arg_fmt);
         };
     }
 #endif
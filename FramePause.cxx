@@ -17,8 +17,8 @@
  *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <iomanip>
-#include <sstream>
+#include <ByteWriter.h>
+#include <FrameFmt.h>
 #include <FramePause.h>
 
 namespace Frames
@@ -39,41 +39,24 @@ namespace Frames
 
     void FramePause::encapsulate(void)
     {
-        BVec mcst;
-        BVec bytes;
+        BVec       bytes;
+        ByteWriter bw(bytes, 4 + PAUSE_PAD_SIZE);
 
-        mcst.push_back(PAUSE_MCST[0]);
-        mcst.push_back(PAUSE_MCST[1]);
-        mcst.push_back(PAUSE_MCST[2]);
-        mcst.push_back(PAUSE_MCST[3]);
-        mcst.push_back(PAUSE_MCST[4]);
-        mcst.push_back(PAUSE_MCST[5]);
+        bw.put_u16(PAUSE_MAC_CTRL);
+        bw.put_u16(this->quanta);
+        bw.put_fill(0x00, PAUSE_PAD_SIZE);
+        bw.finish();
 
-        bytes.push_back((uint8_t)(PAUSE_MAC_CTRL >> 8));
-        bytes.push_back((uint8_t)(PAUSE_MAC_CTRL & 0x00FF));
-        bytes.push_back((uint8_t)(this->quanta >> 8));
-        bytes.push_back((uint8_t)(this->quanta & 0x00FF));
-
-        for (unsigned int i = 0 ; i < PAUSE_PAD_SIZE ; ++i)
-        {
-            bytes.push_back(0x00);
-        }
-
-        this->set_eth_dmac(mcst);
+        this->set_eth_dmac(PAUSE_MCST);
         this->set_eth_type(EtherType::ETYP_FLOW);
-        this->set_eth_payload(bytes);
+        this->set_eth_payload(move(bytes));
         FrameEth::encapsulate();
     }
 
-    string FramePause::gist(void)
+    void FramePause::gist_to(FrameFmt &arg_fmt)
     {
-        stringstream ss;
-
-        ss  << "{"
-            << "quanta:0x" << setfill('0') << setw(4) << hex << this->quanta
-            << ",frame:"   << FrameEth::gist()
-            << "}";
-
-        return ss.str();
+        arg_fmt.put("{quanta:0x"); arg_fmt.put_hex(this->quanta, 4);
+        arg_fmt.put(",frame:");    FrameEth::gist_to(arg_fmt);
+        arg_fmt.put("}");
     }
 }
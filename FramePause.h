@@ -43,7 +43,7 @@
 
                 void set_pause_param(unsigned arg_quanta);
                 virtual void encapsulate(void);
-                virtual std::string gist(void);
+                virtual void gist_to(FrameFmt &arg_fmt);
         };
     }
 #endif
@@ -0,0 +1,283 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <FrameEth.h>
+#include <FrameIPv4.h>
+#include <FrameRewrite.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    FrameRewrite::FrameRewrite(void)
+    {
+        this->data      = nullptr;
+        this->len       = 0;
+        this->tag_count = 0;
+        this->ip_off    = 0;
+        this->l4_off    = 0;
+        this->l4_ck     = 0;
+        this->has_ip    = false;
+        this->has_ports = false;
+    }
+
+    FrameRewrite::~FrameRewrite(void) { }
+
+    bool FrameRewrite::bind(uint8_t *arg_bytes, size_t arg_len)
+    {
+        unsigned off = 12;
+        unsigned ihl;
+        uint16_t type;
+
+        this->data      = nullptr;
+        this->len       = 0;
+        this->tag_count = 0;
+        this->has_ip    = false;
+        this->has_ports = false;
+        this->l4_ck     = 0;
+
+        if (arg_len < 14)
+        {
+            cerr << "FrameRewrite::bind(): frame is shorter than an Ethernet header" << endl << flush;
+            return false;
+        }
+
+        this->data = arg_bytes;
+        this->len  = arg_len;
+        type       = be_load<2>::get(arg_bytes + off);
+
+        while ((type == (uint16_t)EtherType::ETYP_VLAN or type == (uint16_t)EtherType::ETYP_QINQ) and off + 6 <= arg_len)
+        {
+            if (this->tag_count < RewriteMaxTags) this->tags[this->tag_count++] = off + 2;
+
+            off += 4;
+            type = be_load<2>::get(arg_bytes + off);
+        }
+
+        off += 2;
+
+        if (type != (uint16_t)EtherType::ETYP_IPV4 or off + IPV4_HDR_BYTES > arg_len) return true;
+        if ((arg_bytes[off] >> 4) != IPV4_VERS) return true;
+
+        ihl = (arg_bytes[off] & 0x0F) * 4;
+
+        if (ihl < IPV4_HDR_BYTES or off + ihl > arg_len) return true;
+
+        this->has_ip = true;
+        this->ip_off = off;
+        this->l4_off = off + ihl;
+
+        // ports are only present in the first fragment
+        if ((be_load<2>::get(arg_bytes + off + 6) & 0x1FFF) != 0) return true;
+
+        if (arg_bytes[off + 9] == (uint8_t)IPv4Proto::PROTO_UDP and this->l4_off + 8 <= arg_len)
+        {
+            this->has_ports = true;
+            this->l4_ck     = this->l4_off + 6;
+        }
+        else if (arg_bytes[off + 9] == (uint8_t)IPv4Proto::PROTO_TCP and this->l4_off + 20 <= arg_len)
+        {
+            this->has_ports = true;
+            this->l4_ck     = this->l4_off + 16;
+        }
+
+        return true;
+    }
+
+    // a shared buffer is never written through, so a shared one is first
+    // replaced by a private copy; other holders keep the original bytes
+
+    bool FrameRewrite::bind(Buf &arg_buf)
+    {
+        if (arg_buf.refs() > 1)
+        {
+            Buf copy(arg_buf.data(), arg_buf.size());
+
+            arg_buf = move(copy);
+        }
+
+        return this->bind(arg_buf.data(), arg_buf.size());
+    }
+
+    bool FrameRewrite::is_ipv4(void)
+    {
+        return this->has_ip;
+    }
+
+    unsigned FrameRewrite::get_tag_count(void)
+    {
+        return this->tag_count;
+    }
+
+    void FrameRewrite::write(unsigned arg_off, const uint8_t *arg_bytes, unsigned arg_len, bool arg_ip, bool arg_l4)
+    {
+        uint8_t  old[8];
+        unsigned lo = arg_off & ~1u;
+        unsigned hi = (arg_off + arg_len + 1) & ~1u;
+        bool     udp;
+
+        if (this->data == nullptr) return;
+
+        // Ethernet, tag and IPv4 headers are all an even number of bytes, so
+        // frame word alignment matches checksum word alignment
+        memcpy(old, this->data + lo, hi - lo);
+        memcpy(this->data + arg_off, arg_bytes, arg_len);
+
+        if (arg_ip)
+        {
+            uint8_t *ck = this->data + this->ip_off + 10;
+
+            be_store<2>::put(ck, FrameIPv4::cksum_adjust(be_load<2>::get(ck), old, this->data + lo, hi - lo));
+        }
+
+        if (arg_l4 and this->l4_ck)
+        {
+            uint8_t *ck    = this->data + this->l4_ck;
+            uint16_t cksum = be_load<2>::get(ck);
+
+            udp = (this->data[this->ip_off + 9] == (uint8_t)IPv4Proto::PROTO_UDP);
+
+            // a zero UDP checksum means none was sent
+            if (udp and cksum == 0) return;
+
+            cksum = FrameIPv4::cksum_adjust(cksum, old, this->data + lo, hi - lo);
+
+            if (udp and cksum == 0) cksum = 0xFFFF;
+
+            be_store<2>::put(ck, cksum);
+        }
+    }
+
+    bool FrameRewrite::set_eth_dmac(const uint8_t *arg_mac)
+    {
+        if (this->data == nullptr) return false;
+
+        memcpy(this->data + 0, arg_mac, 6);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_eth_smac(const uint8_t *arg_mac)
+    {
+        if (this->data == nullptr) return false;
+
+        memcpy(this->data + 6, arg_mac, 6);
+
+        return true;
+    }
+
+    bool FrameRewrite::swap_eth_macs(void)
+    {
+        uint8_t mac[6];
+
+        if (this->data == nullptr) return false;
+
+        memcpy(mac, this->data + 0, 6);
+        memcpy(this->data + 0, this->data + 6, 6);
+        memcpy(this->data + 6, mac, 6);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_vlan_vid(uint16_t arg_vid, unsigned arg_tag)
+    {
+        uint16_t tci;
+
+        if (arg_tag >= this->tag_count or arg_vid > 0x0FFF)
+        {
+            cerr << "FrameRewrite::set_vlan_vid(): no tag " << arg_tag << " or vid out of range" << endl << flush;
+            return false;
+        }
+
+        tci = (be_load<2>::get(this->data + this->tags[arg_tag]) & 0xF000) | arg_vid;
+        be_store<2>::put(this->data + this->tags[arg_tag], tci);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_ipv4_sip(const uint8_t *arg_ip)
+    {
+        if (not this->has_ip) return false;
+
+        this->write(this->ip_off + 12, arg_ip, 4, true, true);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_ipv4_dip(const uint8_t *arg_ip)
+    {
+        if (not this->has_ip) return false;
+
+        this->write(this->ip_off + 16, arg_ip, 4, true, true);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_ipv4_tos(uint8_t arg_tos)
+    {
+        if (not this->has_ip) return false;
+
+        this->write(this->ip_off + 1, &arg_tos, 1, true, false);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_ipv4_ttl(uint8_t arg_ttl)
+    {
+        if (not this->has_ip) return false;
+
+        this->write(this->ip_off + 8, &arg_ttl, 1, true, false);
+
+        return true;
+    }
+
+    bool FrameRewrite::dec_ipv4_ttl(void)
+    {
+        if (not this->has_ip or this->data[this->ip_off + 8] <= 1) return false;
+
+        return this->set_ipv4_ttl(this->data[this->ip_off + 8] - 1);
+    }
+
+    bool FrameRewrite::set_l4_sport(uint16_t arg_port)
+    {
+        uint8_t port[2];
+
+        if (not this->has_ports) return false;
+
+        be_store<2>::put(port, arg_port);
+        this->write(this->l4_off + 0, port, 2, false, true);
+
+        return true;
+    }
+
+    bool FrameRewrite::set_l4_dport(uint16_t arg_port)
+    {
+        uint8_t port[2];
+
+        if (not this->has_ports) return false;
+
+        be_store<2>::put(port, arg_port);
+        this->write(this->l4_off + 2, port, 2, false, true);
+
+        return true;
+    }
+}
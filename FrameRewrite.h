@@ -0,0 +1,70 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_REWRITE_H_
+    #define _FRAME_REWRITE_H_
+
+    #include <Frame.h>
+    #include <BufPool.h>
+
+    namespace Frames
+    {
+        const unsigned RewriteMaxTags = 4;
+
+        // Edits a received frame in place.  bind() walks the headers once;
+        // each setter then writes its bytes and adjusts the IPv4 header and
+        // TCP/UDP checksums incrementally, without allocating or re-summing.
+
+        class FrameRewrite
+        {
+            private:
+                uint8_t     *data;
+                std::size_t  len;
+                unsigned     tags[RewriteMaxTags];
+                unsigned     tag_count;
+                unsigned     ip_off;
+                unsigned     l4_off;
+                unsigned     l4_ck;
+                bool         has_ip;
+                bool         has_ports;
+
+                void write(unsigned arg_off, const uint8_t *arg_bytes, unsigned arg_len, bool arg_ip, bool arg_l4);
+
+            public:
+                FrameRewrite(void);
+                virtual ~FrameRewrite(void);
+
+                bool bind(uint8_t *arg_bytes, std::size_t arg_len);
+                bool bind(Buf &arg_buf);
+                bool is_ipv4(void);
+                unsigned get_tag_count(void);
+                bool set_eth_dmac(const uint8_t *arg_mac);
+                bool set_eth_smac(const uint8_t *arg_mac);
+                bool swap_eth_macs(void);
+                bool set_vlan_vid(uint16_t arg_vid, unsigned arg_tag = 0);
+                bool set_ipv4_sip(const uint8_t *arg_ip);
+                bool set_ipv4_dip(const uint8_t *arg_ip);
+                bool set_ipv4_tos(uint8_t arg_tos);
+                bool set_ipv4_ttl(uint8_t arg_ttl);
+                bool dec_ipv4_ttl(void);
+                bool set_l4_sport(uint16_t arg_port);
+                bool set_l4_dport(uint16_t arg_port);
+        };
+    }
+#endif
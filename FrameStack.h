@@ -0,0 +1,263 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_STACK_H_
+    #define _FRAME_STACK_H_
+
+    #include <Frame.h>
+    #include <ByteWriter.h>
+    #include <Cksum.h>
+    #include <cstddef>
+    #include <cstdint>
+    #include <cstring>
+    #include <tuple>
+    #include <utility>
+
+    namespace Frames
+    {
+        // Compile-time header stack.  FrameStack<StackEth, StackVlan, StackIPv4>
+        // knows every header offset, the total header length and the EtherType
+        // or IP protocol each layer announces to the one in front of it, so
+        // emit() is a straight run of stores with no per-field validity checks.
+        //
+        // A layer provides:
+        //   bytes  - header length
+        //   etype  - EtherType announced to the previous layer (0: none)
+        //   proto  - IP protocol announced to the previous layer (0: none)
+        //   fields - runtime values, zero-initialised by FrameStack
+        //   emit() - writes the header given the next layer's etype/proto and
+        //            the byte count from the start of this header to frame end
+        //
+        // The 'type' and 'proto' fields are only used when no later layer in
+        // the stack supplies one.
+
+        struct StackEth
+        {
+            static constexpr unsigned bytes = 14;
+            static constexpr uint16_t etype = 0;
+            static constexpr uint8_t  proto = 0;
+
+            struct fields
+            {
+                uint8_t  dmac[6];
+                uint8_t  smac[6];
+                uint16_t type;
+            };
+
+            static void emit(uint8_t *arg_ptr, const fields &arg_f, uint16_t arg_etype, uint8_t, std::size_t)
+            {
+                memcpy(arg_ptr + 0, arg_f.dmac, 6);
+                memcpy(arg_ptr + 6, arg_f.smac, 6);
+                be_store<2>::put(arg_ptr + 12, arg_etype ? arg_etype : arg_f.type);
+            }
+        };
+
+        template <uint16_t ETYPE>
+        struct StackTag
+        {
+            static constexpr unsigned bytes = 4;
+            static constexpr uint16_t etype = ETYPE;
+            static constexpr uint8_t  proto = 0;
+
+            struct fields
+            {
+                uint16_t tci;
+                uint16_t type;
+            };
+
+            static void emit(uint8_t *arg_ptr, const fields &arg_f, uint16_t arg_etype, uint8_t, std::size_t)
+            {
+                be_store<2>::put(arg_ptr + 0, arg_f.tci);
+                be_store<2>::put(arg_ptr + 2, arg_etype ? arg_etype : arg_f.type);
+            }
+        };
+
+        typedef StackTag<0x8100> StackVlan;
+        typedef StackTag<0x88A8> StackQinq;
+
+        struct StackIPv4
+        {
+            static constexpr unsigned bytes = 20;
+            static constexpr uint16_t etype = 0x0800;
+            static constexpr uint8_t  proto = 0;
+
+            struct fields
+            {
+                uint8_t sip[4];
+                uint8_t dip[4];
+                uint8_t proto;
+            };
+
+            static void emit(uint8_t *arg_ptr, const fields &arg_f, uint16_t, uint8_t arg_proto, std::size_t arg_rest)
+            {
+                arg_ptr[0]  = 0x45;
+                arg_ptr[1]  = 0x00;
+                be_store<2>::put(arg_ptr + 2, (uint16_t)arg_rest);
+                arg_ptr[4]  = 0x00;
+                arg_ptr[5]  = 0x00;
+                arg_ptr[6]  = 0x40;
+                arg_ptr[7]  = 0x00;
+                arg_ptr[8]  = 0x20;
+                arg_ptr[9]  = arg_proto ? arg_proto : arg_f.proto;
+                arg_ptr[10] = 0x00;
+                arg_ptr[11] = 0x00;
+
+                memcpy(arg_ptr + 12, arg_f.sip, 4);
+                memcpy(arg_ptr + 16, arg_f.dip, 4);
+
+                be_store<2>::put(arg_ptr + 10, (uint16_t)~Cksum::sum(arg_ptr, bytes));
+            }
+        };
+
+        struct StackUdp
+        {
+            static constexpr unsigned bytes = 8;
+            static constexpr uint16_t etype = 0;
+            static constexpr uint8_t  proto = 0x11;
+
+            struct fields
+            {
+                uint16_t sport;
+                uint16_t dport;
+            };
+
+            static void emit(uint8_t *arg_ptr, const fields &arg_f, uint16_t, uint8_t, std::size_t arg_rest)
+            {
+                be_store<2>::put(arg_ptr + 0, arg_f.sport);
+                be_store<2>::put(arg_ptr + 2, arg_f.dport);
+                be_store<2>::put(arg_ptr + 4, (uint16_t)arg_rest);
+                be_store<2>::put(arg_ptr + 6, 0x0000);
+            }
+        };
+
+        template <typename... L> struct stack_len;
+
+        template <>
+        struct stack_len<>
+        {
+            static constexpr unsigned value = 0;
+        };
+
+        template <typename H, typename... T>
+        struct stack_len<H, T...>
+        {
+            static constexpr unsigned value = H::bytes + stack_len<T...>::value;
+        };
+
+        template <std::size_t I, typename... L> struct stack_offset;
+
+        template <typename H, typename... T>
+        struct stack_offset<0, H, T...>
+        {
+            static constexpr unsigned value = 0;
+        };
+
+        template <std::size_t I, typename H, typename... T>
+        struct stack_offset<I, H, T...>
+        {
+            static constexpr unsigned value = H::bytes + stack_offset<I - 1, T...>::value;
+        };
+
+        template <typename... L>
+        struct stack_next
+        {
+            static constexpr uint16_t etype = 0;
+            static constexpr uint8_t  proto = 0;
+        };
+
+        template <typename H, typename... T>
+        struct stack_next<H, T...>
+        {
+            static constexpr uint16_t etype = H::etype;
+            static constexpr uint8_t  proto = H::proto;
+        };
+
+        template <std::size_t I, typename... L> struct stack_emit;
+
+        template <std::size_t I>
+        struct stack_emit<I>
+        {
+            template <typename F>
+            static void run(uint8_t *, std::size_t, const F &) { }
+        };
+
+        template <std::size_t I, typename H, typename... T>
+        struct stack_emit<I, H, T...>
+        {
+            template <typename F>
+            static void run(uint8_t *arg_ptr, std::size_t arg_rest, const F &arg_fields)
+            {
+                H::emit(arg_ptr, std::get<I>(arg_fields), stack_next<T...>::etype, stack_next<T...>::proto, arg_rest);
+                stack_emit<I + 1, T...>::run(arg_ptr + H::bytes, arg_rest - H::bytes, arg_fields);
+            }
+        };
+
+        template <typename... L>
+        class FrameStack
+        {
+            static_assert(sizeof...(L) > 0, "FrameStack needs at least one layer");
+
+            private:
+                typedef std::tuple<typename L::fields...> fields_t;
+
+                fields_t hdrs;
+
+            public:
+                static constexpr unsigned hdr_len = stack_len<L...>::value;
+
+                template <std::size_t I>
+                static constexpr unsigned offset(void)
+                {
+                    return stack_offset<I, L...>::value;
+                }
+
+                template <std::size_t I>
+                typename std::tuple_element<I, fields_t>::type &layer(void)
+                {
+                    return std::get<I>(this->hdrs);
+                }
+
+                // write the headers in front of arg_len payload bytes that are
+                // already in place at arg_buf + hdr_len
+                void emit_hdr(uint8_t *arg_buf, std::size_t arg_len) const
+                {
+                    stack_emit<0, L...>::run(arg_buf, hdr_len + arg_len, this->hdrs);
+                }
+
+                std::size_t emit(uint8_t *arg_buf, const uint8_t *arg_payload, std::size_t arg_len) const
+                {
+                    this->emit_hdr(arg_buf, arg_len);
+                    memcpy(arg_buf + hdr_len, arg_payload, arg_len);
+
+                    return hdr_len + arg_len;
+                }
+
+                void emit(Frame &arg_frame, const uint8_t *arg_payload, std::size_t arg_len) const
+                {
+                    BVec bytes(hdr_len + arg_len);
+
+                    this->emit(bytes.data(), arg_payload, arg_len);
+                    arg_frame.give_frame(std::move(bytes));
+                }
+        };
+
+        template <typename... L>
+        constexpr unsigned FrameStack<L...>::hdr_len;
+    }
+#endif
@@ -0,0 +1,273 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <FrameEth.h>
+#include <FrameIPv4.h>
+#include <FrameTemplate.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    FrameTemplate::FrameTemplate(void)
+    {
+        this->ip_off  = 0;
+        this->ip_len  = 0;
+        this->l4_off  = 0;
+        this->has_ip  = false;
+        this->has_udp = false;
+    }
+
+    FrameTemplate::~FrameTemplate(void) { }
+
+    bool FrameTemplate::capture(Frame &arg_frame)
+    {
+        const BVec &bytes = arg_frame.peek_frame();
+
+        return this->capture(bytes.data(), bytes.size());
+    }
+
+    bool FrameTemplate::capture(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        if (arg_len < 14)
+        {
+            cerr << "FrameTemplate::capture(): frame is shorter than an Ethernet header" << endl << flush;
+            return false;
+        }
+
+        this->image.assign(arg_bytes, arg_bytes + arg_len);
+        this->points.clear();
+        this->scan();
+
+        return true;
+    }
+
+    void FrameTemplate::scan(void)
+    {
+        const uint8_t *ptr  = this->image.data();
+        size_t         len  = this->image.size();
+        unsigned       off  = 12;
+        unsigned       tags = 0;
+        uint16_t       type = be_load<2>::get(ptr + off);
+
+        this->has_ip  = false;
+        this->has_udp = false;
+
+        this->add_patch("eth.dmac", 0, 6);
+        this->add_patch("eth.smac", 6, 6);
+
+        while ((type == (uint16_t)EtherType::ETYP_VLAN or type == (uint16_t)EtherType::ETYP_QINQ) and off + 6 <= len)
+        {
+            this->add_patch("eth.tag" + to_string(tags++), off + 2, 2);
+            off += 4;
+            type = be_load<2>::get(ptr + off);
+        }
+
+        off += 2;
+
+        if (type != (uint16_t)EtherType::ETYP_IPV4 or off + IPV4_HDR_BYTES > len) return;
+        if ((ptr[off] >> 4) != IPV4_VERS) return;
+
+        this->ip_off = off;
+        this->ip_len = (ptr[off] & 0x0F) * 4;
+
+        if (this->ip_len < IPV4_HDR_BYTES or off + this->ip_len > len) return;
+
+        this->has_ip = true;
+        this->l4_off = off + this->ip_len;
+
+        if (ptr[off + 9] == (uint8_t)IPv4Proto::PROTO_UDP and this->l4_off + 8 <= len)
+        {
+            // a zero UDP checksum means none was sent; leave it alone
+            this->has_udp = (be_load<2>::get(ptr + this->l4_off + 6) != 0);
+        }
+
+        this->add_patch("ipv4.tos", off + 1,  1);
+        this->add_patch("ipv4.id",  off + 4,  2);
+        this->add_patch("ipv4.ttl", off + 8,  1);
+        this->add_patch("ipv4.sip", off + 12, 4);
+        this->add_patch("ipv4.dip", off + 16, 4);
+
+        if (ptr[off + 9] == (uint8_t)IPv4Proto::PROTO_UDP and this->l4_off + 8 <= len)
+        {
+            this->add_patch("udp.sport", this->l4_off + 0, 2);
+            this->add_patch("udp.dport", this->l4_off + 2, 2);
+        }
+    }
+
+    int FrameTemplate::add_patch(string arg_name, unsigned arg_offset, unsigned arg_width)
+    {
+        patch_point pp;
+        unsigned    end = arg_offset + arg_width;
+
+        if (arg_width == 0 or arg_width > PatchMaxBytes or end > this->image.size())
+        {
+            cerr << "FrameTemplate::add_patch(): " << arg_name << " does not fit in the frame" << endl << flush;
+            return -1;
+        }
+
+        pp.name   = arg_name;
+        pp.offset = arg_offset;
+        pp.width  = arg_width;
+        pp.ip_ck  = 0;
+        pp.l4_ck  = 0;
+
+        if (this->has_ip and arg_offset < this->ip_off + this->ip_len and end > this->ip_off)
+        {
+            pp.ip_ck = this->ip_off + 10;
+        }
+
+        if (this->has_udp)
+        {
+            // the UDP checksum covers the addresses through the pseudo-header
+            if (arg_offset >= this->l4_off)                                       pp.l4_ck = this->l4_off + 6;
+            if (arg_offset < this->ip_off + 20 and end > this->ip_off + 12)       pp.l4_ck = this->l4_off + 6;
+        }
+
+        if ((pp.ip_ck and arg_offset < pp.ip_ck + 2u and end > pp.ip_ck) or
+            (pp.l4_ck and arg_offset < pp.l4_ck + 2u and end > pp.l4_ck))
+        {
+            cerr << "FrameTemplate::add_patch(): " << arg_name << " overlaps a checksum" << endl << flush;
+            return -1;
+        }
+
+        this->points.push_back(pp);
+
+        return this->points.size() - 1;
+    }
+
+    int FrameTemplate::find_patch(string arg_name)
+    {
+        for (unsigned i = 0 ; i < this->points.size() ; ++i)
+        {
+            if (this->points[i].name == arg_name) return i;
+        }
+
+        return -1;
+    }
+
+    const patch_point & FrameTemplate::get_patch(unsigned arg_id)
+    {
+        return this->points.at(arg_id);
+    }
+
+    unsigned FrameTemplate::get_patch_count(void)
+    {
+        return this->points.size();
+    }
+
+    unsigned FrameTemplate::get_payload_offset(void)
+    {
+        if (this->has_ip)
+        {
+            return this->l4_off + ((this->image[this->ip_off + 9] == (uint8_t)IPv4Proto::PROTO_UDP) ? 8 : 0);
+        }
+
+        return 14;
+    }
+
+    size_t FrameTemplate::size(void)
+    {
+        return this->image.size();
+    }
+
+    const BVec & FrameTemplate::peek_image(void)
+    {
+        return this->image;
+    }
+
+    void FrameTemplate::stamp(uint8_t *arg_buf)
+    {
+        memcpy(arg_buf, this->image.data(), this->image.size());
+    }
+
+    void FrameTemplate::stamp(Buf &arg_buf)
+    {
+        arg_buf.assign(this->image.data(), this->image.size());
+    }
+
+    bool FrameTemplate::patch(uint8_t *arg_buf, unsigned arg_id, const uint8_t *arg_bytes)
+    {
+        uint8_t  old[PatchMaxBytes + 2];
+        uint8_t  cur[PatchMaxBytes + 2];
+        unsigned lo;
+        unsigned hi;
+        unsigned end;
+
+        if (arg_id >= this->points.size())
+        {
+            cerr << "FrameTemplate::patch(): no patch point " << arg_id << endl << flush;
+            return false;
+        }
+
+        const patch_point &pp = this->points[arg_id];
+
+        // the IPv4 and UDP headers start on even offsets, so word alignment
+        // within the frame matches word alignment within the checksummed data
+        lo = pp.offset & ~1u;
+        hi = (pp.offset + pp.width + 1) & ~1u;
+
+        // a field ending on the last, odd byte of the frame has no partner
+        // byte in the buffer; the checksum pads it with zero, and so do we
+        end = min(hi, (unsigned)this->image.size());
+
+        memset(old, 0, sizeof(old));
+        memset(cur, 0, sizeof(cur));
+        memcpy(old, arg_buf + lo, end - lo);
+        memcpy(arg_buf + pp.offset, arg_bytes, pp.width);
+        memcpy(cur, arg_buf + lo, end - lo);
+
+        if (pp.ip_ck)
+        {
+            be_store<2>::put(arg_buf + pp.ip_ck, FrameIPv4::cksum_adjust(be_load<2>::get(arg_buf + pp.ip_ck), old, cur, hi - lo));
+        }
+
+        if (pp.l4_ck)
+        {
+            uint16_t cksum = FrameIPv4::cksum_adjust(be_load<2>::get(arg_buf + pp.l4_ck), old, cur, hi - lo);
+
+            be_store<2>::put(arg_buf + pp.l4_ck, cksum ? cksum : 0xFFFF);
+        }
+
+        return true;
+    }
+
+    bool FrameTemplate::patch(uint8_t *arg_buf, unsigned arg_id, uint64_t arg_val)
+    {
+        uint8_t bytes[8];
+
+        if (arg_id >= this->points.size() or this->points[arg_id].width > 8)
+        {
+            cerr << "FrameTemplate::patch(): patch point " << arg_id << " cannot take an integer" << endl << flush;
+            return false;
+        }
+
+        for (int i = this->points[arg_id].width - 1 ; i >= 0 ; --i)
+        {
+            bytes[i] = (uint8_t)(arg_val & 0xFF);
+            arg_val >>= 8;
+        }
+
+        return this->patch(arg_buf, arg_id, bytes);
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_TEMPLATE_H_
+    #define _FRAME_TEMPLATE_H_
+
+    #include <Frame.h>
+    #include <BufPool.h>
+
+    namespace Frames
+    {
+        const unsigned PatchMaxBytes = 16;
+
+        struct patch_point
+        {
+            std::string name;
+            uint16_t    offset;
+            uint8_t     width;
+            uint16_t    ip_ck;
+            uint16_t    l4_ck;
+        };
+
+        // A frame image captured once from an encapsulated frame.  stamp()
+        // copies the image out and patch() rewrites a named field in the copy,
+        // fixing up the IPv4 header and UDP checksums incrementally.  capture()
+        // registers eth.dmac, eth.smac, eth.tagN, ipv4.tos, ipv4.id, ipv4.ttl,
+        // ipv4.sip, ipv4.dip, udp.sport and udp.dport where present.
+
+        class FrameTemplate
+        {
+            private:
+                BVec                     image;
+                std::vector<patch_point> points;
+                unsigned                 ip_off;
+                unsigned                 ip_len;
+                unsigned                 l4_off;
+                bool                     has_ip;
+                bool                     has_udp;
+
+                void scan(void);
+
+            public:
+                FrameTemplate(void);
+                virtual ~FrameTemplate(void);
+
+                bool capture(Frame &arg_frame);
+                bool capture(const uint8_t *arg_bytes, std::size_t arg_len);
+                int  add_patch(std::string arg_name, unsigned arg_offset, unsigned arg_width);
+                int  find_patch(std::string arg_name);
+                const patch_point & get_patch(unsigned arg_id);
+                unsigned get_patch_count(void);
+                unsigned get_payload_offset(void);
+                std::size_t size(void);
+                const BVec & peek_image(void);
+                void stamp(uint8_t *arg_buf);
+                void stamp(Buf &arg_buf);
+                bool patch(uint8_t *arg_buf, unsigned arg_id, const uint8_t *arg_bytes);
+                bool patch(uint8_t *arg_buf, unsigned arg_id, uint64_t arg_val);
+        };
+    }
+#endif
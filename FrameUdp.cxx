@@ -0,0 +1,208 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <ByteWriter.h>
+#include <Cksum.h>
+#include <FrameFmt.h>
+#include <FrameUdp.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    FrameUdp::FrameUdp(void) : FrameIPv4()
+    {
+        this->spec[ UDP_SPORT ].clear();
+        this->spec[ UDP_DPORT ].clear();
+        this->spec_payload       = {false, BVec()};
+        this->cksum_zero         = false;
+    }
+
+    FrameUdp::~FrameUdp(void) { }
+
+    void FrameUdp::set_udp_sport(uint16_t arg_port)
+    {
+        uint8_t port[2];
+
+        be_store<2>::put(port, arg_port);
+        this->spec[UDP_SPORT].set(port, 2);
+    }
+
+    void FrameUdp::set_udp_dport(uint16_t arg_port)
+    {
+        uint8_t port[2];
+
+        be_store<2>::put(port, arg_port);
+        this->spec[UDP_DPORT].set(port, 2);
+    }
+
+    void FrameUdp::set_udp_payload(const BVec &arg_pyld)
+    {
+        this->spec_payload.bytes.insert(this->spec_payload.bytes.end(), arg_pyld.begin(), arg_pyld.end());
+        this->spec_payload.valid = true;
+    }
+
+    void FrameUdp::set_udp_payload(BVec &&arg_pyld)
+    {
+        if (this->spec_payload.bytes.empty())
+        {
+            this->spec_payload.bytes.swap(arg_pyld);
+            this->spec_payload.valid = true;
+            return;
+        }
+
+        this->set_udp_payload((const BVec &)arg_pyld);
+    }
+
+    // a zero checksum tells the receiver none was computed (RFC 768)
+    void FrameUdp::set_udp_cksum_zero(bool arg_zero)
+    {
+        this->cksum_zero = arg_zero;
+    }
+
+    void FrameUdp::encapsulate(void)
+    {
+        bool     okay    = true;
+        string   errmsg  = "[ERR] encapsulate(): cannot encapsulate with an invalid";
+        BVec    &payload = this->spec_payload.bytes;
+        uint32_t ulength = payload.size() + UDP_HDR_BYTES;
+        uint8_t *hdr;
+
+        if (not this->spec[ UDP_SPORT ].valid) okay = false;
+        if (not this->spec[ UDP_DPORT ].valid) okay = false;
+        if (ulength > 65535)                   okay = false;
+
+        if (not this->spec[ UDP_SPORT ].valid) cerr << errmsg << " sport"  << endl << flush;
+        if (not this->spec[ UDP_DPORT ].valid) cerr << errmsg << " dport"  << endl << flush;
+        if (ulength > 65535)                   cerr << errmsg << " length" << endl << flush;
+
+        if (not okay) exit(1);
+
+        this->set_ipv4_proto(IPv4Proto::PROTO_UDP);
+
+        HeadBuf buf(this->ipv4_hdr_len() + UDP_HDR_BYTES, payload.size());
+
+        buf.append(payload);
+
+        hdr = buf.prepend(UDP_HDR_BYTES);
+
+        memcpy(hdr + 0, this->spec[UDP_SPORT].bytes, 2);
+        memcpy(hdr + 2, this->spec[UDP_DPORT].bytes, 2);
+        be_store<2>::put(hdr + 4, ulength);
+        be_store<2>::put(hdr + 6, 0x0000);
+
+        if (not this->cksum_zero)
+        {
+            uint16_t cksum = ~Cksum::sum(hdr, ulength, this->ipv4_pseudo_sum(ulength));
+
+            be_store<2>::put(hdr + 6, cksum ? cksum : 0xFFFF);
+        }
+
+        this->encap_ipv4(buf);
+
+        this->spec_payload.valid = false;
+        this->spec_payload.bytes.clear();
+    }
+
+    // Builds arg_count datagrams into pooled buffers.  The Ethernet and IPv4
+    // headers, the IPv4 checksum and the pseudo-header sum are produced once;
+    // each datagram then only writes its ports and lengths, adjusts the IPv4
+    // checksum for its length (RFC 1624) and sums its own UDP bytes.  The
+    // Ethernet and IPv4 specs are consumed as by encapsulate(); the UDP port
+    // and payload specs are not used.
+    int FrameUdp::encapsulate_batch(const udp_datagram *arg_dgrams, unsigned arg_count, vector<Buf> &arg_bufs)
+    {
+        BVec     head;
+        uint16_t pseudo;
+        uint16_t ip_cksum;
+        size_t   ip_off;
+        uint8_t  tlen_old[2];
+
+        for (unsigned i = 0 ; i < arg_count ; ++i)
+        {
+            if (arg_dgrams[i].len + UDP_HDR_BYTES + IPV4_HDR_BYTES > 65535)
+            {
+                cerr << "[ERR] encapsulate_batch(): datagram " << i << " is too long" << endl << flush;
+                return -1;
+            }
+        }
+
+        this->set_ipv4_proto(IPv4Proto::PROTO_UDP);
+
+        HeadBuf buf(this->ipv4_hdr_len() + UDP_HDR_BYTES);
+
+        memset(buf.prepend(UDP_HDR_BYTES), 0, UDP_HDR_BYTES);
+
+        pseudo = this->ipv4_pseudo_sum(0);
+
+        this->encap_ipv4(buf);
+        this->take_frame(head);
+
+        ip_off   = head.size() - UDP_HDR_BYTES - IPV4_HDR_BYTES;
+        ip_cksum = (head[ip_off + 10] << 8) + head[ip_off + 11];
+
+        memcpy(tlen_old, &head[ip_off + 2], 2);
+
+        arg_bufs.resize(arg_count);
+
+        for (unsigned i = 0 ; i < arg_count ; ++i)
+        {
+            const udp_datagram &dg      = arg_dgrams[i];
+            uint16_t            ulength = dg.len + UDP_HDR_BYTES;
+            Buf                &out     = arg_bufs[i];
+            uint8_t            *ip;
+            uint8_t            *udp;
+
+            out = Buf(head.size() + dg.len);
+            ip  = out.data() + ip_off;
+            udp = ip + IPV4_HDR_BYTES;
+
+            memcpy(out.data(), head.data(), head.size());
+            memcpy(udp + UDP_HDR_BYTES, dg.payload, dg.len);
+
+            be_store<2>::put(ip + 2, ulength + IPV4_HDR_BYTES);
+            be_store<2>::put(ip + 10, FrameIPv4::cksum_adjust(ip_cksum, tlen_old, ip + 2, 2));
+
+            be_store<2>::put(udp + 0, dg.sport);
+            be_store<2>::put(udp + 2, dg.dport);
+            be_store<2>::put(udp + 4, ulength);
+
+            if (not this->cksum_zero)
+            {
+                uint16_t cksum = ~Cksum::sum(udp, ulength, Cksum::sum(udp + 4, 2, pseudo));
+
+                be_store<2>::put(udp + 6, cksum ? cksum : 0xFFFF);
+            }
+        }
+
+        return arg_count;
+    }
+
+    void FrameUdp::gist_to(FrameFmt &arg_fmt)
+    {
+        arg_fmt.put("{spec:");
+        arg_fmt.put("UDP_SPORT:");    arg_fmt.gist_field(this->spec[UDP_SPORT]);
+        arg_fmt.put(",UDP_DPORT:");   arg_fmt.gist_field(this->spec[UDP_DPORT]);
+        arg_fmt.put(",UDP_PAYLOAD:"); arg_fmt.gist_item(this->spec_payload);
+        arg_fmt.put(",frame:");       FrameIPv4::gist_to(arg_fmt);
+        arg_fmt.put("}");
+    }
+}
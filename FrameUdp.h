@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_UDP_H_
+    #define _FRAME_UDP_H_
+
+    #include <FrameIPv4.h>
+    #include <BufPool.h>
+
+    namespace Frames
+    {
+        const unsigned UDP_HDR_BYTES = 8;
+
+        struct udp_datagram
+        {
+            uint16_t       sport;
+            uint16_t       dport;
+            const uint8_t *payload;
+            std::size_t    len;
+        };
+
+        class FrameUdp : public FrameIPv4
+        {
+            private:
+                std::array<field, UDP_PAYLOAD> spec;
+                item                           spec_payload;
+                bool                           cksum_zero;
+
+            public:
+                FrameUdp(void);
+                virtual ~FrameUdp(void);
+
+                void set_udp_sport(uint16_t arg_port);
+                void set_udp_dport(uint16_t arg_port);
+                void set_udp_payload(const BVec &arg_payload);
+                void set_udp_payload(BVec &&arg_payload);
+                void set_udp_cksum_zero(bool arg_zero);
+                int  encapsulate_batch(const udp_datagram *arg_dgrams, unsigned arg_count, std::vector<Buf> &arg_bufs);
+
+                virtual void encapsulate(void);
+                virtual void gist_to(FrameFmt &arg_fmt);
+        };
+    }
+#endif
@@ -0,0 +1,49 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <FrameView.h>
+#include <Frame.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    FrameView::FrameView(void)
+    {
+        this->data       = NULL;
+        this->caplen     = 0;
+        this->len        = 0;
+        this->ts.tv_sec  = 0;
+        this->ts.tv_nsec = 0;
+    }
+
+    FrameView::FrameView(const struct pcap_pkthdr *arg_hdr, const uint8_t *arg_pkt, bool arg_nano)
+    {
+        this->data       = arg_pkt;
+        this->caplen     = (arg_hdr->caplen < arg_hdr->len) ? arg_hdr->caplen : arg_hdr->len;
+        this->len        = arg_hdr->len;
+        this->ts.tv_sec  = arg_hdr->ts.tv_sec;
+        this->ts.tv_nsec = (arg_nano) ? arg_hdr->ts.tv_usec : arg_hdr->ts.tv_usec * 1000;
+    }
+
+    void FrameView::materialize(Frame &arg_frame) const
+    {
+        arg_frame.load_frame(this->data, this->caplen);
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_VIEW_H_
+    #define _FRAME_VIEW_H_
+
+    #include <cstdint>
+    #include <ctime>
+    #include <functional>
+    #include <pcap.h>
+
+    namespace Frames
+    {
+        class Frame;
+
+        class FrameView
+        {
+            public:
+                const uint8_t   *data;
+                uint32_t         caplen;
+                uint32_t         len;
+                struct timespec  ts;
+
+                FrameView(void);
+                FrameView(const struct pcap_pkthdr *arg_hdr, const uint8_t *arg_pkt, bool arg_nano = false);
+
+                void materialize(Frame &arg_frame) const;
+        };
+
+        typedef std::function<void(const FrameView &)> ViewHandler;
+    }
+#endif
@@ -25,15 +25,11 @@ namespace Frames
 
     void insert_vlan(FrameEth &arg_eth, unsigned arg_tci)
     {
-        BVec    type;
-        BVec    tci;
-        uint8_t tci1 = (uint8_t)((arg_tci & 0xFF00) >> 8);
-        uint8_t tci0 = (uint8_t)(arg_tci & 0x00FF);
+        BVec type;
+        BVec tci;
 
         arg_eth.get_vec_eth_type(type, EtherType::ETYP_VLAN);
-
-        tci.push_back(tci1);
-        tci.push_back(tci0);
+        Frame::to_bvec(tci, (uint16_t)arg_tci);
 
         arg_eth.insert(type, tci);
     }
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <HeadBuf.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    HeadBuf::HeadBuf(size_t arg_headroom, size_t arg_body)
+    {
+        this->bytes.reserve(arg_headroom + arg_body);
+        this->bytes.resize(arg_headroom);
+        this->head = arg_headroom;
+    }
+
+    uint8_t * HeadBuf::prepend(size_t arg_len)
+    {
+        if (arg_len > this->head)
+        {
+            // slow path, only taken when the headroom was underestimated
+            size_t grow = arg_len - this->head;
+
+            this->bytes.insert(this->bytes.begin(), grow, 0);
+            this->head += grow;
+        }
+
+        this->head -= arg_len;
+
+        return this->bytes.data() + this->head;
+    }
+
+    void HeadBuf::append(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        this->bytes.insert(this->bytes.end(), arg_bytes, arg_bytes + arg_len);
+    }
+
+    void HeadBuf::append(const BVec &arg_bytes)
+    {
+        this->bytes.insert(this->bytes.end(), arg_bytes.begin(), arg_bytes.end());
+    }
+
+    uint8_t * HeadBuf::data(void)
+    {
+        return this->bytes.data() + this->head;
+    }
+
+    size_t HeadBuf::size(void) const
+    {
+        return this->bytes.size() - this->head;
+    }
+
+    size_t HeadBuf::headroom(void) const
+    {
+        return this->head;
+    }
+
+    BVec HeadBuf::release(void)
+    {
+        BVec out;
+
+        if (this->head != 0)
+        {
+            this->bytes.erase(this->bytes.begin(), this->bytes.begin() + this->head);
+            this->head = 0;
+        }
+
+        out.swap(this->bytes);
+
+        return out;
+    }
+}
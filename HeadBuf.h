@@ -0,0 +1,49 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_HEAD_BUF_H_
+    #define _FRAME_HEAD_BUF_H_
+
+    #include <Frame.h>
+
+    namespace Frames
+    {
+        // Byte buffer with reserved space in front of its contents, so that each
+        // protocol layer can prepend its header in place around a payload that
+        // was written once.
+
+        class HeadBuf
+        {
+            private:
+                BVec        bytes;
+                std::size_t head;
+
+            public:
+                HeadBuf(std::size_t arg_headroom, std::size_t arg_body = 0);
+
+                uint8_t * prepend(std::size_t arg_len);
+                void append(const uint8_t *arg_bytes, std::size_t arg_len);
+                void append(const BVec &arg_bytes);
+                uint8_t * data(void);
+                std::size_t size(void) const;
+                std::size_t headroom(void) const;
+                BVec release(void);
+        };
+    }
+#endif
@@ -0,0 +1,147 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <Nic.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    Nic::Nic(void)
+    {
+        this->txq_count = 0;
+    }
+
+    Nic::~Nic(void) { }
+
+    bool Nic::rx_filter(string arg_expr)
+    {
+        cerr << "Nic::rx_filter(): filters are not supported by this backend" << endl << flush;
+        return false;
+    }
+
+    bool Nic::rx_frame(BVec &arg_bytes)
+    {
+        int ret;
+
+        ret = this->rx_view(1, [&arg_bytes](const FrameView &arg_view)
+        {
+            arg_bytes.assign(arg_view.data, arg_view.data + arg_view.caplen);
+        });
+
+        return (ret > 0);
+    }
+
+    int Nic::rx_burst(unsigned arg_max, struct rx_burst &arg_burst)
+    {
+        arg_burst.count = 0;
+
+        if (arg_max == 0) return 0;
+
+        arg_burst.reserve(arg_max);
+
+        return this->rx_view(arg_max, [&arg_burst](const FrameView &arg_view)
+        {
+            rx_slot &slot = arg_burst.slots[arg_burst.count++];
+
+            slot.hdr.ts.tv_sec  = arg_view.ts.tv_sec;
+            slot.hdr.ts.tv_usec = arg_view.ts.tv_nsec / 1000;
+            slot.hdr.caplen     = arg_view.caplen;
+            slot.hdr.len        = arg_view.len;
+            slot.bytes.assign(arg_view.data, arg_view.data + arg_view.caplen);
+        });
+    }
+
+    int Nic::rx_bufs(unsigned arg_max, vector<Buf> &arg_bufs)
+    {
+        arg_bufs.clear();
+
+        if (arg_max == 0) return 0;
+
+        return this->rx_view(arg_max, [&arg_bufs](const FrameView &arg_view)
+        {
+            arg_bufs.push_back(Buf(arg_view.data, arg_view.caplen));
+        });
+    }
+
+    bool Nic::tx_queue(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        if (this->txq_count == TxQueueDepth)
+        {
+            cerr << "Nic::tx_queue(): queue is full" << endl << flush;
+            return false;
+        }
+
+        if (this->txq.size() == this->txq_count) this->txq.push_back(Buf());
+
+        this->txq[this->txq_count++].assign(arg_bytes, arg_len);
+
+        return true;
+    }
+
+    // the bytes are copied into a pooled buffer; the caller's vector is left as it was
+    bool Nic::tx_queue(const BVec &arg_bytes)
+    {
+        return this->tx_queue(arg_bytes.data(), arg_bytes.size());
+    }
+
+    bool Nic::tx_queue(const Buf &arg_buf)
+    {
+        if (this->txq_count == TxQueueDepth)
+        {
+            cerr << "Nic::tx_queue(): queue is full" << endl << flush;
+            return false;
+        }
+
+        if (this->txq.size() == this->txq_count) this->txq.push_back(Buf());
+
+        // shares the buffer, so one frame queued on several nics is not copied
+        this->txq[this->txq_count++] = arg_buf;
+
+        return true;
+    }
+
+    unsigned Nic::tx_depth(void)
+    {
+        return this->txq_count;
+    }
+
+    int Nic::tx_flush(vector<int> &arg_results)
+    {
+        int sent = 0;
+
+        arg_results.assign(this->txq_count, -1);
+
+        for (unsigned i = 0 ; i < this->txq_count ; i++)
+        {
+            if (this->tx_frame(this->txq[i].data(), this->txq[i].size()))
+            {
+                arg_results[i] = this->txq[i].size();
+                sent++;
+            }
+
+            if (this->txq[i].refs() > 1) this->txq[i].reset();
+        }
+
+        this->txq_count = 0;
+
+        return sent;
+    }
+}
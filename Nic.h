@@ -0,0 +1,57 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_NIC_H_
+    #define _FRAME_NIC_H_
+
+    #include <Frame.h>
+    #include <FrameView.h>
+    #include <BufPool.h>
+
+    namespace Frames
+    {
+        const unsigned TxQueueDepth = 512;
+
+        class Nic
+        {
+            protected:
+                std::vector<Buf>  txq;
+                unsigned          txq_count;
+
+            public:
+                Nic(void);
+                virtual ~Nic(void);
+
+                virtual bool open(std::string arg_name) = 0;
+                virtual void close(void) = 0;
+                virtual bool rx_filter(std::string arg_expr);
+                virtual bool rx_frame(BVec &arg_bytes);
+                virtual int  rx_burst(unsigned arg_max, struct rx_burst &arg_burst);
+                virtual int  rx_view(unsigned arg_max, ViewHandler arg_handler) = 0;
+                int  rx_bufs(unsigned arg_max, std::vector<Buf> &arg_bufs);
+                virtual bool tx_frame(const uint8_t *arg_bytes, std::size_t arg_len) = 0;
+                virtual int  tx_flush(std::vector<int> &arg_results);
+
+                bool tx_queue(const uint8_t *arg_bytes, std::size_t arg_len);
+                bool tx_queue(const BVec &arg_bytes);
+                bool tx_queue(const Buf &arg_buf);
+                unsigned tx_depth(void);
+        };
+    }
+#endif
@@ -0,0 +1,227 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <NicPcap.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    static void rx_burst_handler(u_char *arg_user, const struct pcap_pkthdr *arg_hdr, const u_char *arg_pkt)
+    {
+        rx_burst *burst   = (rx_burst *)arg_user;
+        rx_slot  &slot    = burst->slots[burst->count];
+        uint32_t  len_min = (arg_hdr->caplen < arg_hdr->len) ? arg_hdr->caplen : arg_hdr->len;
+
+        slot.hdr = *arg_hdr;
+        slot.bytes.assign(arg_pkt, arg_pkt + len_min);
+
+        burst->count++;
+    }
+
+    struct rx_view_ctx
+    {
+        ViewHandler *handler;
+        bool         nano;
+    };
+
+    static void rx_view_handler(u_char *arg_user, const struct pcap_pkthdr *arg_hdr, const u_char *arg_pkt)
+    {
+        rx_view_ctx *ctx = (rx_view_ctx *)arg_user;
+        FrameView    view(arg_hdr, arg_pkt, ctx->nano);
+
+        (*ctx->handler)(view);
+    }
+
+    NicPcap::NicPcap(void) : Nic()
+    {
+        this->nic_errbuf[0] = '\0';
+        this->nic_handle    = NULL;
+        this->nic_nano      = false;
+    }
+
+    NicPcap::~NicPcap(void)
+    {
+        this->close();
+    }
+
+    bool NicPcap::open(string arg_name)
+    {
+        #ifndef PCAP_DISABLE
+            this->nic_errbuf[0] = '\0';
+            this->nic_handle    = pcap_open_live(arg_name.c_str(), NicSnapLen, 0, 100, this->nic_errbuf);
+
+            if (this->nic_handle == NULL)
+            {
+                cerr << "NicPcap::open(): failure opening device " << this->nic_errbuf << endl << flush;
+                return false;
+            }
+
+            if (strlen(this->nic_errbuf) != 0)
+            {
+                cerr << "NicPcap::open(): warning opening device " << this->nic_errbuf << endl << flush;
+                return false;
+            }
+        #endif
+
+        return true;
+    }
+
+    void NicPcap::close(void)
+    {
+        #ifndef PCAP_DISABLE
+            if (this->nic_handle != NULL)
+            {
+                pcap_close(this->nic_handle);
+            }
+
+            this->nic_handle = NULL;
+        #endif
+    }
+
+    bool NicPcap::rx_filter(string arg_expr)
+    {
+        int      ret;
+
+        #ifndef PCAP_DISABLE
+            ret = pcap_compile(this->nic_handle, &this->nic_bpf, arg_expr.c_str(), 0, PCAP_NETMASK_UNKNOWN);
+
+            if (ret < 0)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::rx_filter(): pcap_compile failure");
+                return false;
+            }
+
+            ret = pcap_setfilter(this->nic_handle, &this->nic_bpf);
+
+            if (ret < 0)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::rx_filter(): pcap_setfilter failure");
+                return false;
+            }
+        #endif
+
+        return true;
+    }
+
+    bool NicPcap::rx_frame(BVec &arg_bytes)
+    {
+        struct pcap_pkthdr *hdr;
+        const uint8_t      *pkt;
+        int                 ret;
+        uint32_t            len_min;
+
+        #ifndef PCAP_DISABLE
+            ret = pcap_next_ex(this->nic_handle, &hdr, &pkt);
+
+            if (ret == 0)
+            {
+                cerr << "NicPcap::rx_frame(): timeout" << endl << flush;
+                return false;
+            }
+            else if (ret == -1)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::rx_frame(): failure");
+                return false;
+            }
+            else if (ret == -2)
+            {
+                cerr << "NicPcap::rx_frame(): savefile EOF" << endl << flush;
+                return false;
+            }
+
+            if (hdr->caplen < hdr->len)
+            {
+                    len_min = hdr->caplen;
+            }
+            else
+            {
+                    len_min = hdr->len;
+            }
+
+            arg_bytes.assign(pkt, pkt + len_min);
+        #endif
+
+        return true;
+    }
+
+    int NicPcap::rx_burst(unsigned arg_max, struct rx_burst &arg_burst)
+    {
+        int ret;
+
+        arg_burst.count = 0;
+
+        if (arg_max == 0) return 0;
+
+        arg_burst.reserve(arg_max);
+
+        #ifndef PCAP_DISABLE
+            ret = pcap_dispatch(this->nic_handle, arg_max, rx_burst_handler, (u_char *)&arg_burst);
+
+            if (ret == -1)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::rx_burst(): failure");
+                return -1;
+            }
+        #endif
+
+        return arg_burst.count;
+    }
+
+    int NicPcap::rx_view(unsigned arg_max, ViewHandler arg_handler)
+    {
+        rx_view_ctx ctx = {&arg_handler, this->nic_nano};
+        int         ret = 0;
+
+        if (arg_max == 0) return 0;
+
+        #ifndef PCAP_DISABLE
+            ret = pcap_dispatch(this->nic_handle, arg_max, rx_view_handler, (u_char *)&ctx);
+
+            if (ret == -1)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::rx_view(): failure");
+                return -1;
+            }
+
+            if (ret == -2) ret = 0;
+        #endif
+
+        return ret;
+    }
+
+    bool NicPcap::tx_frame(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        int ret;
+
+        #ifndef PCAP_DISABLE
+            ret = pcap_inject(this->nic_handle, arg_bytes, arg_len);
+
+            if (ret < 0)
+            {
+                pcap_perror(this->nic_handle, "NicPcap::tx_frame(): failure");
+                return false;
+            }
+        #endif
+
+        return true;
+    }
+}
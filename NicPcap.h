@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_NIC_PCAP_H_
+    #define _FRAME_NIC_PCAP_H_
+
+    #include <Nic.h>
+
+    namespace Frames
+    {
+        class NicPcap : public Nic
+        {
+            protected:
+                char         nic_errbuf[PCAP_ERRBUF_SIZE];
+                pcap_t      *nic_handle;
+                pcap_bpf     nic_bpf;
+                bool         nic_nano;
+
+            public:
+                NicPcap(void);
+                virtual ~NicPcap(void);
+
+                virtual bool open(std::string arg_name);
+                virtual void close(void);
+                virtual bool rx_filter(std::string arg_expr);
+                virtual bool rx_frame(BVec &arg_bytes);
+                virtual int  rx_burst(unsigned arg_max, struct rx_burst &arg_burst);
+                virtual int  rx_view(unsigned arg_max, ViewHandler arg_handler);
+                virtual bool tx_frame(const uint8_t *arg_bytes, std::size_t arg_len);
+        };
+    }
+#endif
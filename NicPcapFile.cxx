@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <NicPcapFile.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    NicPcapFile::NicPcapFile(bool arg_nano) : NicPcap()
+    {
+        this->want_nano = arg_nano;
+    }
+
+    NicPcapFile::~NicPcapFile(void) { }
+
+    bool NicPcapFile::open(string arg_path)
+    {
+        #ifndef PCAP_DISABLE
+            this->nic_errbuf[0] = '\0';
+            this->nic_handle    = pcap_open_offline_with_tstamp_precision(arg_path.c_str(),
+                                      (this->want_nano) ? PCAP_TSTAMP_PRECISION_NANO : PCAP_TSTAMP_PRECISION_MICRO,
+                                      this->nic_errbuf);
+
+            if (this->nic_handle == NULL)
+            {
+                cerr << "NicPcapFile::open(): failure opening savefile " << this->nic_errbuf << endl << flush;
+                return false;
+            }
+
+            this->nic_nano = this->want_nano;
+        #endif
+
+        return true;
+    }
+
+    bool NicPcapFile::tx_frame(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        cerr << "NicPcapFile::tx_frame(): savefile is read only" << endl << flush;
+        return false;
+    }
+}
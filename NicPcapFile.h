@@ -0,0 +1,40 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_NIC_PCAP_FILE_H_
+    #define _FRAME_NIC_PCAP_FILE_H_
+
+    #include <NicPcap.h>
+
+    namespace Frames
+    {
+        class NicPcapFile : public NicPcap
+        {
+            private:
+                bool want_nano;
+
+            public:
+                NicPcapFile(bool arg_nano = false);
+                virtual ~NicPcapFile(void);
+
+                virtual bool open(std::string arg_path);
+                virtual bool tx_frame(const uint8_t *arg_bytes, std::size_t arg_len);
+        };
+    }
+#endif
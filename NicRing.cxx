@@ -0,0 +1,431 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <NicRing.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    NicRing::NicRing(void) : Nic()
+    {
+        ring_cfg dflt = {RingBlockSize, RingBlockCount, RingFrameSize, RingRetireMs};
+
+        this->cfg      = dflt;
+        this->stats    = {0, 0, 0};
+        this->sock     = -1;
+        this->ring     = NULL;
+        this->ring_len = 0;
+        this->blk_idx  = 0;
+        this->blk_left = 0;
+        this->blk_pkt  = NULL;
+
+        this->fanout        = false;
+        this->fanout_defrag = false;
+        this->fanout_group  = 0;
+    }
+
+    NicRing::NicRing(const ring_cfg &arg_cfg) : NicRing()
+    {
+        this->cfg = arg_cfg;
+    }
+
+    NicRing::~NicRing(void)
+    {
+        this->close();
+    }
+
+    uint8_t * NicRing::block(unsigned arg_idx)
+    {
+        return this->ring + ((size_t)arg_idx * this->cfg.block_size);
+    }
+
+    bool NicRing::block_ready(void)
+    {
+        struct tpacket_block_desc *desc = (struct tpacket_block_desc *)this->block(this->blk_idx);
+
+        if ((__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0) return false;
+
+        this->blk_left = desc->hdr.bh1.num_pkts;
+        this->blk_pkt  = (uint8_t *)desc + desc->hdr.bh1.offset_to_first_pkt;
+
+        return true;
+    }
+
+    void NicRing::block_release(void)
+    {
+        struct tpacket_block_desc *desc = (struct tpacket_block_desc *)this->block(this->blk_idx);
+
+        __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+
+        this->blk_idx  = (this->blk_idx + 1) % this->cfg.block_count;
+        this->blk_pkt  = NULL;
+        this->blk_left = 0;
+    }
+
+    bool NicRing::get_stats(ring_stats &arg_stats)
+    {
+        struct tpacket_stats_v3 kstats;
+        socklen_t               len = sizeof(kstats);
+
+        if (this->sock < 0)
+        {
+            cerr << "NicRing::get_stats(): ring is not open" << endl << flush;
+            return false;
+        }
+
+        if (getsockopt(this->sock, SOL_PACKET, PACKET_STATISTICS, &kstats, &len) < 0)
+        {
+            cerr << "NicRing::get_stats(): getsockopt failure " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        // the kernel clears its counters on every read
+        this->stats.packets += kstats.tp_packets;
+        this->stats.drops   += kstats.tp_drops;
+        this->stats.freezes += kstats.tp_freeze_q_cnt;
+
+        arg_stats = this->stats;
+
+        return true;
+    }
+
+    // Every NicRing opened on one device with the same group id joins one
+    // PACKET_FANOUT_HASH group: the kernel spreads frames across the group's
+    // sockets by flow hash, so each socket can feed its own worker.  With
+    // arg_defrag the kernel reassembles IPv4 fragments first, so they hash
+    // with the rest of their flow.
+
+    bool NicRing::set_fanout(uint16_t arg_group, bool arg_defrag)
+    {
+        if (this->sock >= 0)
+        {
+            cerr << "NicRing::set_fanout(): fanout must be set before open()" << endl << flush;
+            return false;
+        }
+
+        this->fanout        = true;
+        this->fanout_defrag = arg_defrag;
+        this->fanout_group  = arg_group;
+
+        return true;
+    }
+
+    bool NicRing::open(string arg_name)
+    {
+        int                 vers = TPACKET_V3;
+        struct tpacket_req3 req;
+        struct sockaddr_ll  addr;
+        unsigned            ifindex;
+
+        this->close();
+
+        if ((this->cfg.frame_size == 0) or (this->cfg.frame_size % TPACKET_ALIGNMENT))
+        {
+            cerr << "NicRing::open(): frame size must be a non-zero multiple of " << TPACKET_ALIGNMENT << endl << flush;
+            return false;
+        }
+
+        if ((this->cfg.block_size % getpagesize()) or (this->cfg.block_size % this->cfg.frame_size))
+        {
+            cerr << "NicRing::open(): block size must be a multiple of the page and frame sizes" << endl << flush;
+            return false;
+        }
+
+        ifindex = if_nametoindex(arg_name.c_str());
+
+        if (ifindex == 0)
+        {
+            cerr << "NicRing::open(): unknown device " << arg_name << endl << flush;
+            return false;
+        }
+
+        this->sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+
+        if (this->sock < 0)
+        {
+            cerr << "NicRing::open(): socket failure " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        if (setsockopt(this->sock, SOL_PACKET, PACKET_VERSION, &vers, sizeof(vers)) < 0)
+        {
+            cerr << "NicRing::open(): PACKET_VERSION failure " << strerror(errno) << endl << flush;
+            this->close();
+            return false;
+        }
+
+        memset(&req, 0, sizeof(req));
+        req.tp_block_size       = this->cfg.block_size;
+        req.tp_block_nr         = this->cfg.block_count;
+        req.tp_frame_size       = this->cfg.frame_size;
+        req.tp_frame_nr         = (this->cfg.block_size / this->cfg.frame_size) * this->cfg.block_count;
+        req.tp_retire_blk_tov   = this->cfg.retire_ms;
+        req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+
+        if (setsockopt(this->sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+        {
+            cerr << "NicRing::open(): PACKET_RX_RING failure " << strerror(errno) << endl << flush;
+            this->close();
+            return false;
+        }
+
+        this->ring_len = (size_t)req.tp_block_size * req.tp_block_nr;
+        this->ring     = (uint8_t *)mmap(NULL, this->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, this->sock, 0);
+
+        if (this->ring == MAP_FAILED)
+        {
+            this->ring = (uint8_t *)mmap(NULL, this->ring_len, PROT_READ | PROT_WRITE, MAP_SHARED, this->sock, 0);
+        }
+
+        if (this->ring == MAP_FAILED)
+        {
+            cerr << "NicRing::open(): mmap failure " << strerror(errno) << endl << flush;
+            this->ring = NULL;
+            this->close();
+            return false;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family   = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_ALL);
+        addr.sll_ifindex  = ifindex;
+
+        if (bind(this->sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            cerr << "NicRing::open(): bind failure " << strerror(errno) << endl << flush;
+            this->close();
+            return false;
+        }
+
+        if (this->fanout)
+        {
+            int mode = PACKET_FANOUT_HASH | (this->fanout_defrag ? PACKET_FANOUT_FLAG_DEFRAG : 0);
+            int arg  = this->fanout_group | (mode << 16);
+
+            if (setsockopt(this->sock, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) < 0)
+            {
+                cerr << "NicRing::open(): PACKET_FANOUT failure " << strerror(errno) << endl << flush;
+                this->close();
+                return false;
+            }
+        }
+
+        this->blk_idx  = 0;
+        this->blk_left = 0;
+        this->blk_pkt  = NULL;
+
+        return true;
+    }
+
+    void NicRing::close(void)
+    {
+        if (this->ring != NULL)
+        {
+            munmap(this->ring, this->ring_len);
+        }
+
+        if (this->sock >= 0)
+        {
+            ::close(this->sock);
+        }
+
+        this->ring     = NULL;
+        this->ring_len = 0;
+        this->sock     = -1;
+    }
+
+    bool NicRing::rx_filter(string arg_expr)
+    {
+        pcap_t          *dead;
+        pcap_bpf         bpf;
+        struct sock_fprog prog;
+        int              ret;
+
+        dead = pcap_open_dead(DLT_EN10MB, NicSnapLen);
+
+        if (dead == NULL)
+        {
+            cerr << "NicRing::rx_filter(): pcap_open_dead failure" << endl << flush;
+            return false;
+        }
+
+        if (pcap_compile(dead, &bpf, arg_expr.c_str(), 1, PCAP_NETMASK_UNKNOWN) < 0)
+        {
+            pcap_perror(dead, "NicRing::rx_filter(): pcap_compile failure");
+            pcap_close(dead);
+            return false;
+        }
+
+        prog.len    = bpf.bf_len;
+        prog.filter = (struct sock_filter *)bpf.bf_insns;
+        ret         = setsockopt(this->sock, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog));
+
+        pcap_freecode(&bpf);
+        pcap_close(dead);
+
+        if (ret < 0)
+        {
+            cerr << "NicRing::rx_filter(): SO_ATTACH_FILTER failure " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        return true;
+    }
+
+    int NicRing::rx_view(unsigned arg_max, ViewHandler arg_handler)
+    {
+        struct tpacket3_hdr *hdr;
+        struct pollfd        pfd;
+        FrameView            view;
+        unsigned             count = 0;
+
+        if (this->ring == NULL)
+        {
+            cerr << "NicRing::rx_view(): ring is not open" << endl << flush;
+            return -1;
+        }
+
+        if ((this->blk_pkt == NULL) and (not this->block_ready()))
+        {
+            pfd.fd      = this->sock;
+            pfd.events  = POLLIN | POLLERR;
+            pfd.revents = 0;
+
+            if (poll(&pfd, 1, RingPollMs) < 0)
+            {
+                cerr << "NicRing::rx_view(): poll failure " << strerror(errno) << endl << flush;
+                return -1;
+            }
+
+            if (not this->block_ready()) return 0;
+        }
+
+        while (count < arg_max)
+        {
+            if (this->blk_left == 0)
+            {
+                this->block_release();
+
+                if (not this->block_ready()) break;
+                if (this->blk_left == 0) continue;
+            }
+
+            hdr = (struct tpacket3_hdr *)this->blk_pkt;
+
+            view.data       = this->blk_pkt + hdr->tp_mac;
+            view.caplen     = hdr->tp_snaplen;
+            view.len        = hdr->tp_len;
+            view.ts.tv_sec  = hdr->tp_sec;
+            view.ts.tv_nsec = hdr->tp_nsec;
+
+            arg_handler(view);
+
+            this->blk_pkt += hdr->tp_next_offset;
+            this->blk_left--;
+            count++;
+        }
+
+        if ((this->blk_pkt != NULL) and (this->blk_left == 0))
+        {
+            this->block_release();
+        }
+
+        return count;
+    }
+
+    bool NicRing::tx_frame(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        if (send(this->sock, arg_bytes, arg_len, 0) < 0)
+        {
+            cerr << "NicRing::tx_frame(): send failure " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        return true;
+    }
+
+    int NicRing::tx_flush(vector<int> &arg_results)
+    {
+        struct mmsghdr msgs[RingTxBatch];
+        struct iovec   iovs[RingTxBatch];
+        unsigned       base = 0;
+        unsigned       todo;
+        int            ret;
+        int            sent = 0;
+
+        arg_results.assign(this->txq_count, -1);
+
+        while (base < this->txq_count)
+        {
+            todo = this->txq_count - base;
+            todo = (todo > RingTxBatch) ? RingTxBatch : todo;
+
+            for (unsigned i = 0 ; i < todo ; i++)
+            {
+                iovs[i].iov_base = this->txq[base + i].data();
+                iovs[i].iov_len  = this->txq[base + i].size();
+
+                memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_iov    = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            ret = sendmmsg(this->sock, msgs, todo, 0);
+
+            if (ret < 0)
+            {
+                // the frame at base is the one the kernel refused; skip past it
+                arg_results[base] = -errno;
+                cerr << "NicRing::tx_flush(): sendmmsg failure " << strerror(errno) << endl << flush;
+                base++;
+                continue;
+            }
+
+            for (int i = 0 ; i < ret ; i++)
+            {
+                arg_results[base + i] = msgs[i].msg_len;
+            }
+
+            base += ret;
+            sent += ret;
+        }
+
+        for (unsigned i = 0 ; i < this->txq_count ; i++)
+        {
+            if (this->txq[i].refs() > 1) this->txq[i].reset();
+        }
+
+        this->txq_count = 0;
+
+        return sent;
+    }
+}
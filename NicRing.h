@@ -0,0 +1,84 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_NIC_RING_H_
+    #define _FRAME_NIC_RING_H_
+
+    #include <Nic.h>
+
+    namespace Frames
+    {
+        const unsigned RingBlockSize  = 1 << 22;
+        const unsigned RingBlockCount = 64;
+        const unsigned RingFrameSize  = 1 << 11;
+        const unsigned RingRetireMs   = 60;
+        const int      RingPollMs     = 100;
+        const unsigned RingTxBatch    = 64;
+
+        struct ring_cfg
+        {
+            unsigned block_size;
+            unsigned block_count;
+            unsigned frame_size;
+            unsigned retire_ms;
+        };
+
+        struct ring_stats
+        {
+            uint64_t packets;
+            uint64_t drops;
+            uint64_t freezes;
+        };
+
+        class NicRing : public Nic
+        {
+            private:
+                ring_cfg    cfg;
+                ring_stats  stats;
+                int         sock;
+                uint8_t    *ring;
+                std::size_t ring_len;
+                unsigned    blk_idx;
+                unsigned    blk_left;
+                uint8_t    *blk_pkt;
+                bool        fanout;
+                bool        fanout_defrag;
+                uint16_t    fanout_group;
+
+                uint8_t * block(unsigned arg_idx);
+                bool block_ready(void);
+                void block_release(void);
+
+            public:
+                NicRing(void);
+                NicRing(const ring_cfg &arg_cfg);
+                virtual ~NicRing(void);
+
+                bool get_stats(ring_stats &arg_stats);
+                bool set_fanout(uint16_t arg_group, bool arg_defrag = true);
+
+                virtual bool open(std::string arg_name);
+                virtual void close(void);
+                virtual bool rx_filter(std::string arg_expr);
+                virtual int  rx_view(unsigned arg_max, ViewHandler arg_handler);
+                virtual bool tx_frame(const uint8_t *arg_bytes, std::size_t arg_len);
+                virtual int  tx_flush(std::vector<int> &arg_results);
+        };
+    }
+#endif
@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <NicWire.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    NicWire::NicWire(void) : Nic()
+    {
+        this->rx_ring  = NULL;
+        this->tx_ring  = NULL;
+        this->tx_drops = 0;
+    }
+
+    NicWire::~NicWire(void) { }
+
+    void NicWire::connect(WireRing &arg_rx, WireRing &arg_tx)
+    {
+        this->rx_ring = &arg_rx;
+        this->tx_ring = &arg_tx;
+    }
+
+    uint64_t NicWire::get_tx_drops(void)
+    {
+        return this->tx_drops;
+    }
+
+    bool NicWire::open(string arg_name)
+    {
+        if ((this->rx_ring == NULL) or (this->tx_ring == NULL))
+        {
+            cerr << "NicWire::open(): wire is not connected" << endl << flush;
+            return false;
+        }
+
+        return true;
+    }
+
+    void NicWire::close(void) { }
+
+    int NicWire::rx_view(unsigned arg_max, ViewHandler arg_handler)
+    {
+        wire_slot *slot;
+        FrameView  view;
+        unsigned   count = 0;
+
+        while (count < arg_max)
+        {
+            slot = this->rx_ring->pop_slot();
+
+            if (slot == NULL) break;
+
+            view.data   = slot->bytes.data();
+            view.caplen = slot->bytes.size();
+            view.len    = slot->bytes.size();
+            view.ts     = slot->ts;
+
+            arg_handler(view);
+
+            this->rx_ring->pop_commit();
+            count++;
+        }
+
+        return count;
+    }
+
+    bool NicWire::tx_frame(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        wire_slot *slot = this->tx_ring->push_slot();
+
+        if (slot == NULL)
+        {
+            this->tx_drops++;
+            return false;
+        }
+
+        clock_gettime(CLOCK_REALTIME, &slot->ts);
+        slot->bytes.assign(arg_bytes, arg_bytes + arg_len);
+
+        this->tx_ring->push_commit();
+
+        return true;
+    }
+
+    WirePair::WirePair(unsigned arg_depth) : a_to_b(arg_depth), b_to_a(arg_depth)
+    {
+        this->a.connect(this->b_to_a, this->a_to_b);
+        this->b.connect(this->a_to_b, this->b_to_a);
+    }
+
+    NicWire & WirePair::end_a(void)
+    {
+        return this->a;
+    }
+
+    NicWire & WirePair::end_b(void)
+    {
+        return this->b;
+    }
+}
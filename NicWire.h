@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_NIC_WIRE_H_
+    #define _FRAME_NIC_WIRE_H_
+
+    #include <Nic.h>
+    #include <Ring.h>
+
+    namespace Frames
+    {
+        const unsigned WireDepth = 1024;
+
+        struct wire_slot
+        {
+            struct timespec ts;
+            BVec            bytes;
+        };
+
+        typedef SpscRing<wire_slot> WireRing;
+
+        class NicWire : public Nic
+        {
+            private:
+                WireRing *rx_ring;
+                WireRing *tx_ring;
+                uint64_t  tx_drops;
+
+            public:
+                NicWire(void);
+                virtual ~NicWire(void);
+
+                void connect(WireRing &arg_rx, WireRing &arg_tx);
+                uint64_t get_tx_drops(void);
+
+                virtual bool open(std::string arg_name);
+                virtual void close(void);
+                virtual int  rx_view(unsigned arg_max, ViewHandler arg_handler);
+                virtual bool tx_frame(const uint8_t *arg_bytes, std::size_t arg_len);
+        };
+
+        class WirePair
+        {
+            private:
+                WireRing a_to_b;
+                WireRing b_to_a;
+                NicWire  a;
+                NicWire  b;
+
+            public:
+                WirePair(unsigned arg_depth = WireDepth);
+
+                NicWire & end_a(void);
+                NicWire & end_b(void);
+        };
+    }
+#endif
@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAP_FMT_H_
+    #define _FRAME_PCAP_FMT_H_
+
+    #include <cstdint>
+
+    namespace Frames
+    {
+        const uint32_t PcapMagicUsec = 0xa1b2c3d4;
+        const uint32_t PcapMagicNsec = 0xa1b23c4d;
+        const uint16_t PcapVersMajor = 2;
+        const uint16_t PcapVersMinor = 4;
+        const uint32_t PcapLinkEth   = 1;
+
+        const uint32_t NgBlockShb    = 0x0A0D0D0A;
+        const uint32_t NgBlockIdb    = 0x00000001;
+        const uint32_t NgBlockSpb    = 0x00000003;
+        const uint32_t NgBlockEpb    = 0x00000006;
+        const uint32_t NgByteOrder   = 0x1A2B3C4D;
+        const uint16_t NgVersMajor   = 1;
+        const uint16_t NgVersMinor   = 0;
+        const uint16_t NgOptEnd      = 0;
+        const uint16_t NgOptIfName   = 2;
+        const uint16_t NgOptTsresol  = 9;
+        const uint8_t  NgTsresolNsec = 9;
+
+        struct pcap_file_hdr
+        {
+            uint32_t magic;
+            uint16_t vers_major;
+            uint16_t vers_minor;
+            int32_t  thiszone;
+            uint32_t sigfigs;
+            uint32_t snaplen;
+            uint32_t linktype;
+        };
+
+        struct pcap_rec_hdr
+        {
+            uint32_t ts_sec;
+            uint32_t ts_frac;
+            uint32_t caplen;
+            uint32_t len;
+        };
+
+        struct ng_block_hdr
+        {
+            uint32_t type;
+            uint32_t len;
+        };
+
+        struct ng_shb
+        {
+            ng_block_hdr hdr;
+            uint32_t     byte_order;
+            uint16_t     vers_major;
+            uint16_t     vers_minor;
+            int64_t      section_len;
+        } __attribute__((packed));
+
+        struct ng_idb
+        {
+            ng_block_hdr hdr;
+            uint16_t     linktype;
+            uint16_t     reserved;
+            uint32_t     snaplen;
+        };
+
+        struct ng_epb
+        {
+            ng_block_hdr hdr;
+            uint32_t     if_id;
+            uint32_t     ts_high;
+            uint32_t     ts_low;
+            uint32_t     caplen;
+            uint32_t     len;
+        };
+    }
+#endif
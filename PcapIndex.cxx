@@ -0,0 +1,270 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <PcapIndex.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    static uint64_t ts_to_ns(const struct timespec &arg_ts)
+    {
+        return ((uint64_t)arg_ts.tv_sec * 1000000000ULL) + arg_ts.tv_nsec;
+    }
+
+    PcapIndex::PcapIndex(void)
+    {
+        memset(&this->hdr, 0, sizeof(this->hdr));
+        this->built = false;
+    }
+
+    PcapIndex::~PcapIndex(void) { }
+
+    bool PcapIndex::stat_cap(pcap_idx_hdr &arg_hdr)
+    {
+        struct stat st;
+
+        if (stat(this->cap_path.c_str(), &st) < 0)
+        {
+            cerr << "PcapIndex::stat_cap(): failure on " << this->cap_path << " " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        memset(&arg_hdr, 0, sizeof(arg_hdr));
+        arg_hdr.magic          = PcapIdxMagic;
+        arg_hdr.vers           = PcapIdxVers;
+        arg_hdr.cap_size       = st.st_size;
+        arg_hdr.cap_mtime_sec  = st.st_mtim.tv_sec;
+        arg_hdr.cap_mtime_nsec = st.st_mtim.tv_nsec;
+
+        return true;
+    }
+
+    bool PcapIndex::open(string arg_path)
+    {
+        this->close();
+
+        this->cap_path = arg_path;
+        this->idx_path = arg_path + ".idx";
+
+        if (not this->cap.open(arg_path)) return false;
+
+        this->cap.advise(false);
+
+        // a stale or missing side-car is only rebuilt on first lookup
+        this->built = this->load();
+
+        return true;
+    }
+
+    void PcapIndex::close(void)
+    {
+        this->cap.close();
+        this->recs.clear();
+        this->built = false;
+    }
+
+    bool PcapIndex::load(void)
+    {
+        pcap_idx_hdr want;
+        pcap_idx_hdr have;
+        struct stat  st;
+        FILE        *fp;
+        bool         okay;
+
+        if (not this->stat_cap(want)) return false;
+
+        fp = fopen(this->idx_path.c_str(), "rb");
+
+        if (fp == NULL) return false;
+
+        okay = (fread(&have, sizeof(have), 1, fp) == 1);
+        okay = okay and (have.magic          == want.magic);
+        okay = okay and (have.vers           == want.vers);
+        okay = okay and (have.cap_size       == want.cap_size);
+        okay = okay and (have.cap_mtime_sec  == want.cap_mtime_sec);
+        okay = okay and (have.cap_mtime_nsec == want.cap_mtime_nsec);
+
+        // the record count must match the side-car's size before it sizes anything
+        okay = okay and (fstat(fileno(fp), &st) == 0) and ((uint64_t)st.st_size >= sizeof(have));
+        okay = okay and (have.count == ((uint64_t)st.st_size - sizeof(have)) / sizeof(pcap_idx_rec));
+        okay = okay and (((uint64_t)st.st_size - sizeof(have)) % sizeof(pcap_idx_rec) == 0);
+
+        if (okay)
+        {
+            this->recs.resize(have.count);
+            okay = (fread(this->recs.data(), sizeof(pcap_idx_rec), have.count, fp) == have.count);
+        }
+
+        fclose(fp);
+
+        if (not okay)
+        {
+            this->recs.clear();
+            return false;
+        }
+
+        this->hdr = have;
+
+        return true;
+    }
+
+    bool PcapIndex::rebuild(void)
+    {
+        FrameView    view;
+        pcap_idx_rec rec;
+        uint64_t     last = 0;
+
+        if (not this->stat_cap(this->hdr)) return false;
+
+        // the capture may have changed since it was mapped
+        if (this->cap.get_size() != this->hdr.cap_size)
+        {
+            if (not this->cap.open(this->cap_path)) return false;
+        }
+
+        this->recs.clear();
+        this->recs.reserve(this->cap.get_size() / 128);
+        this->hdr.sorted = 1;
+
+        this->cap.advise(true);
+        this->cap.rewind();
+
+        for (rec.offset = this->cap.tell() ; this->cap.next(view) ; rec.offset = this->cap.tell())
+        {
+            rec.ts_ns = ts_to_ns(view.ts);
+
+            if (rec.ts_ns < last) this->hdr.sorted = 0;
+
+            last = rec.ts_ns;
+            this->recs.push_back(rec);
+        }
+
+        this->cap.advise(false);
+
+        this->hdr.count = this->recs.size();
+        this->built     = true;
+
+        return this->save();
+    }
+
+    bool PcapIndex::save(void)
+    {
+        FILE *fp;
+        bool  okay;
+
+        fp = fopen(this->idx_path.c_str(), "wb");
+
+        if (fp == NULL)
+        {
+            cerr << "PcapIndex::save(): failure opening " << this->idx_path << " " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        okay = (fwrite(&this->hdr, sizeof(this->hdr), 1, fp) == 1);
+        okay = okay and (fwrite(this->recs.data(), sizeof(pcap_idx_rec), this->recs.size(), fp) == this->recs.size());
+        okay = (fclose(fp) == 0) and okay;
+
+        if (not okay)
+        {
+            cerr << "PcapIndex::save(): failure writing " << this->idx_path << endl << flush;
+        }
+
+        return okay;
+    }
+
+    bool PcapIndex::ready(void)
+    {
+        if (this->built) return true;
+
+        return this->rebuild();
+    }
+
+    uint64_t PcapIndex::get_count(void)
+    {
+        if (not this->ready()) return 0;
+
+        return this->recs.size();
+    }
+
+    bool PcapIndex::view_frame(uint64_t arg_num, FrameView &arg_view)
+    {
+        if (not this->ready()) return false;
+
+        if (arg_num >= this->recs.size())
+        {
+            cerr << "PcapIndex::view_frame(): frame " << arg_num << " is past the end of the capture" << endl << flush;
+            return false;
+        }
+
+        if (not this->cap.seek(this->recs[arg_num].offset)) return false;
+
+        return this->cap.next(arg_view);
+    }
+
+    bool PcapIndex::load_frame(uint64_t arg_num, Frame &arg_frame)
+    {
+        FrameView view;
+
+        if (not this->view_frame(arg_num, view)) return false;
+
+        view.materialize(arg_frame);
+
+        return true;
+    }
+
+    bool PcapIndex::seek_time(const struct timespec &arg_ts, uint64_t &arg_num)
+    {
+        uint64_t ts_ns = ts_to_ns(arg_ts);
+
+        if (not this->ready()) return false;
+
+        if (this->hdr.sorted)
+        {
+            auto it = lower_bound(this->recs.begin(), this->recs.end(), ts_ns,
+                                  [](const pcap_idx_rec &arg_rec, uint64_t arg_ns) { return arg_rec.ts_ns < arg_ns; });
+
+            arg_num = it - this->recs.begin();
+        }
+        else
+        {
+            for (arg_num = 0 ; arg_num < this->recs.size() ; arg_num++)
+            {
+                if (this->recs[arg_num].ts_ns >= ts_ns) break;
+            }
+        }
+
+        return (arg_num < this->recs.size());
+    }
+
+    bool PcapIndex::load_time(const struct timespec &arg_ts, Frame &arg_frame)
+    {
+        uint64_t num;
+
+        if (not this->seek_time(arg_ts, num)) return false;
+
+        return this->load_frame(num, arg_frame);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAP_INDEX_H_
+    #define _FRAME_PCAP_INDEX_H_
+
+    #include <PcapMap.h>
+
+    namespace Frames
+    {
+        const uint32_t PcapIdxMagic = 0x58494643;
+        const uint32_t PcapIdxVers  = 1;
+
+        struct pcap_idx_hdr
+        {
+            uint32_t magic;
+            uint32_t vers;
+            uint64_t cap_size;
+            int64_t  cap_mtime_sec;
+            int64_t  cap_mtime_nsec;
+            uint64_t count;
+            uint64_t sorted;
+        };
+
+        struct pcap_idx_rec
+        {
+            uint64_t offset;
+            uint64_t ts_ns;
+        };
+
+        // The side-car is checked against the capture's size and mtime only at
+        // open(); the capture must not change while the index is open.
+
+        class PcapIndex
+        {
+            private:
+                PcapMap                   cap;
+                std::string               cap_path;
+                std::string               idx_path;
+                pcap_idx_hdr              hdr;
+                std::vector<pcap_idx_rec> recs;
+                bool                      built;
+
+                bool stat_cap(pcap_idx_hdr &arg_hdr);
+                bool load(void);
+                bool ready(void);
+
+            public:
+                PcapIndex(void);
+                virtual ~PcapIndex(void);
+
+                bool open(std::string arg_path);
+                void close(void);
+                bool rebuild(void);
+                bool save(void);
+                uint64_t get_count(void);
+                bool view_frame(uint64_t arg_num, FrameView &arg_view);
+                bool load_frame(uint64_t arg_num, Frame &arg_frame);
+                bool seek_time(const struct timespec &arg_ts, uint64_t &arg_num);
+                bool load_time(const struct timespec &arg_ts, Frame &arg_frame);
+        };
+    }
+#endif
@@ -0,0 +1,233 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <PcapMap.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    PcapMap::PcapMap(void)
+    {
+        this->fd       = -1;
+        this->base     = NULL;
+        this->size     = 0;
+        this->pos      = 0;
+        this->swap     = false;
+        this->nano     = false;
+        this->snaplen  = 0;
+        this->linktype = 0;
+    }
+
+    PcapMap::~PcapMap(void)
+    {
+        this->close();
+    }
+
+    uint32_t PcapMap::rd32(const uint8_t *arg_ptr) const
+    {
+        uint32_t val;
+
+        memcpy(&val, arg_ptr, sizeof(val));
+
+        return (this->swap) ? __builtin_bswap32(val) : val;
+    }
+
+    uint16_t PcapMap::rd16(const uint8_t *arg_ptr) const
+    {
+        uint16_t val;
+
+        memcpy(&val, arg_ptr, sizeof(val));
+
+        return (this->swap) ? __builtin_bswap16(val) : val;
+    }
+
+    bool PcapMap::open(string arg_path)
+    {
+        struct stat st;
+        uint32_t    magic;
+        void       *map;
+
+        this->close();
+
+        this->fd = ::open(arg_path.c_str(), O_RDONLY);
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapMap::open(): failure opening " << arg_path << " " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        if ((fstat(this->fd, &st) < 0) or ((size_t)st.st_size < sizeof(pcap_file_hdr)))
+        {
+            cerr << "PcapMap::open(): " << arg_path << " is too short for a pcap header" << endl << flush;
+            this->close();
+            return false;
+        }
+
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, this->fd, 0);
+
+        if (map == MAP_FAILED)
+        {
+            cerr << "PcapMap::open(): mmap failure " << strerror(errno) << endl << flush;
+            this->close();
+            return false;
+        }
+
+        this->base = (const uint8_t *)map;
+        this->size = st.st_size;
+
+        memcpy(&magic, this->base, sizeof(magic));
+
+        if      (magic == PcapMagicUsec)                    { this->swap = false; this->nano = false; }
+        else if (magic == PcapMagicNsec)                    { this->swap = false; this->nano = true;  }
+        else if (magic == __builtin_bswap32(PcapMagicUsec)) { this->swap = true;  this->nano = false; }
+        else if (magic == __builtin_bswap32(PcapMagicNsec)) { this->swap = true;  this->nano = true;  }
+        else
+        {
+            cerr << "PcapMap::open(): " << arg_path << " has no pcap magic" << endl << flush;
+            this->close();
+            return false;
+        }
+
+        if (this->rd16(this->base + 4) != PcapVersMajor)
+        {
+            cerr << "PcapMap::open(): " << arg_path << " has an unsupported version" << endl << flush;
+            this->close();
+            return false;
+        }
+
+        this->snaplen  = this->rd32(this->base + 16);
+        this->linktype = this->rd32(this->base + 20) & 0x0FFFFFFF;
+        this->pos      = sizeof(pcap_file_hdr);
+
+        this->advise(true);
+
+        return true;
+    }
+
+    void PcapMap::close(void)
+    {
+        if (this->base != NULL)
+        {
+            munmap((void *)this->base, this->size);
+        }
+
+        if (this->fd >= 0)
+        {
+            ::close(this->fd);
+        }
+
+        this->fd   = -1;
+        this->base = NULL;
+        this->size = 0;
+        this->pos  = 0;
+    }
+
+    void PcapMap::advise(bool arg_sequential)
+    {
+        if (this->base == NULL) return;
+
+        madvise((void *)this->base, this->size, (arg_sequential) ? MADV_SEQUENTIAL : MADV_RANDOM);
+    }
+
+    bool PcapMap::next(FrameView &arg_view)
+    {
+        const uint8_t *rec;
+        uint32_t       caplen;
+
+        if (this->pos + sizeof(pcap_rec_hdr) > this->size) return false;
+
+        rec    = this->base + this->pos;
+        caplen = this->rd32(rec + 8);
+
+        if (caplen > this->size - this->pos - sizeof(pcap_rec_hdr))
+        {
+            cerr << "PcapMap::next(): truncated record at offset " << this->pos << endl << flush;
+            this->pos = this->size;
+            return false;
+        }
+
+        arg_view.data       = rec + sizeof(pcap_rec_hdr);
+        arg_view.caplen     = caplen;
+        arg_view.len        = this->rd32(rec + 12);
+        arg_view.ts.tv_sec  = this->rd32(rec);
+        arg_view.ts.tv_nsec = (this->nano) ? this->rd32(rec + 4) : this->rd32(rec + 4) * 1000;
+
+        this->pos += sizeof(pcap_rec_hdr) + caplen;
+
+        return true;
+    }
+
+    bool PcapMap::next(Frame &arg_frame)
+    {
+        FrameView view;
+
+        if (not this->next(view)) return false;
+
+        view.materialize(arg_frame);
+
+        return true;
+    }
+
+    bool PcapMap::seek(size_t arg_offset)
+    {
+        if ((this->base == NULL) or (arg_offset < sizeof(pcap_file_hdr)) or (arg_offset > this->size))
+        {
+            cerr << "PcapMap::seek(): offset " << arg_offset << " is outside the capture" << endl << flush;
+            return false;
+        }
+
+        this->pos = arg_offset;
+
+        return true;
+    }
+
+    void PcapMap::rewind(void)
+    {
+        this->pos = sizeof(pcap_file_hdr);
+    }
+
+    size_t PcapMap::tell(void) const
+    {
+        return this->pos;
+    }
+
+    size_t PcapMap::get_size(void) const
+    {
+        return this->size;
+    }
+
+    bool PcapMap::is_nano(void) const
+    {
+        return this->nano;
+    }
+
+    uint32_t PcapMap::get_linktype(void) const
+    {
+        return this->linktype;
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAP_MAP_H_
+    #define _FRAME_PCAP_MAP_H_
+
+    #include <Frame.h>
+    #include <FrameView.h>
+    #include <PcapFmt.h>
+
+    namespace Frames
+    {
+        class PcapMap
+        {
+            private:
+                int            fd;
+                const uint8_t *base;
+                std::size_t    size;
+                std::size_t    pos;
+                bool           swap;
+                bool           nano;
+                uint32_t       snaplen;
+                uint32_t       linktype;
+
+                uint16_t rd16(const uint8_t *arg_ptr) const;
+                uint32_t rd32(const uint8_t *arg_ptr) const;
+
+            public:
+                PcapMap(void);
+                virtual ~PcapMap(void);
+
+                bool open(std::string arg_path);
+                void close(void);
+                void advise(bool arg_sequential);
+                bool next(FrameView &arg_view);
+                bool next(Frame &arg_frame);
+                bool seek(std::size_t arg_offset);
+                void rewind(void);
+                std::size_t tell(void) const;
+                std::size_t get_size(void) const;
+                bool is_nano(void) const;
+                uint32_t get_linktype(void) const;
+        };
+    }
+#endif
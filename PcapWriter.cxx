@@ -0,0 +1,197 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <PcapWriter.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    PcapWriter::PcapWriter(size_t arg_buf_len)
+    {
+        this->fd      = -1;
+        this->nano    = false;
+        this->snaplen = NicSnapLen;
+        this->fill    = 0;
+        this->frames  = 0;
+
+        this->buf.resize(arg_buf_len);
+    }
+
+    PcapWriter::~PcapWriter(void)
+    {
+        this->close();
+    }
+
+    bool PcapWriter::drain(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        ssize_t ret;
+
+        while (arg_len > 0)
+        {
+            ret = ::write(this->fd, arg_bytes, arg_len);
+
+            if (ret < 0)
+            {
+                if (errno == EINTR) continue;
+
+                cerr << "PcapWriter::drain(): write failure " << strerror(errno) << endl << std::flush;
+                return false;
+            }
+
+            arg_bytes += ret;
+            arg_len   -= ret;
+        }
+
+        return true;
+    }
+
+    bool PcapWriter::open(string arg_path, bool arg_nano, uint32_t arg_snaplen)
+    {
+        pcap_file_hdr hdr;
+
+        this->close();
+
+        this->fd = ::open(arg_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapWriter::open(): failure opening " << arg_path << " " << strerror(errno) << endl << std::flush;
+            return false;
+        }
+
+        this->nano    = arg_nano;
+        this->snaplen = arg_snaplen;
+        this->fill    = 0;
+        this->frames  = 0;
+
+        hdr.magic      = (arg_nano) ? PcapMagicNsec : PcapMagicUsec;
+        hdr.vers_major = PcapVersMajor;
+        hdr.vers_minor = PcapVersMinor;
+        hdr.thiszone   = 0;
+        hdr.sigfigs    = 0;
+        hdr.snaplen    = arg_snaplen;
+        hdr.linktype   = PcapLinkEth;
+
+        memcpy(this->buf.data(), &hdr, sizeof(hdr));
+        this->fill = sizeof(hdr);
+
+        return true;
+    }
+
+    bool PcapWriter::write(const uint8_t *arg_bytes, uint32_t arg_len, const struct timespec &arg_ts, uint32_t arg_wire_len)
+    {
+        pcap_rec_hdr rec;
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapWriter::write(): file is not open" << endl << std::flush;
+            return false;
+        }
+
+        rec.ts_sec  = arg_ts.tv_sec;
+        rec.ts_frac = (this->nano) ? arg_ts.tv_nsec : arg_ts.tv_nsec / 1000;
+        rec.caplen  = (arg_len > this->snaplen) ? this->snaplen : arg_len;
+        rec.len     = (arg_wire_len > arg_len) ? arg_wire_len : arg_len;
+
+        if (this->fill + sizeof(rec) + rec.caplen > this->buf.size())
+        {
+            if (not this->flush()) return false;
+        }
+
+        memcpy(this->buf.data() + this->fill, &rec, sizeof(rec));
+        this->fill += sizeof(rec);
+
+        if (rec.caplen > this->buf.size() - this->fill)
+        {
+            // larger than the whole buffer, so bypass it
+            if (not this->flush()) return false;
+            if (not this->drain(arg_bytes, rec.caplen)) return false;
+        }
+        else
+        {
+            memcpy(this->buf.data() + this->fill, arg_bytes, rec.caplen);
+            this->fill += rec.caplen;
+        }
+
+        this->frames++;
+
+        return true;
+    }
+
+    bool PcapWriter::write(const FrameView &arg_view)
+    {
+        return this->write(arg_view.data, arg_view.caplen, arg_view.ts, arg_view.len);
+    }
+
+    bool PcapWriter::write(Frame &arg_frame, const struct timespec &arg_ts)
+    {
+        const BVec &bytes = arg_frame.peek_frame();
+
+        return this->write(bytes.data(), bytes.size(), arg_ts);
+    }
+
+    bool PcapWriter::write(Frame &arg_frame)
+    {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+
+        return this->write(arg_frame, ts);
+    }
+
+    bool PcapWriter::flush(void)
+    {
+        bool okay = true;
+
+        if (this->fd < 0) return false;
+
+        if (this->fill > 0)
+        {
+            okay       = this->drain(this->buf.data(), this->fill);
+            this->fill = 0;
+        }
+
+        return okay;
+    }
+
+    bool PcapWriter::close(void)
+    {
+        bool okay = true;
+
+        if (this->fd < 0) return true;
+
+        okay = this->flush();
+
+        ::close(this->fd);
+        this->fd = -1;
+
+        return okay;
+    }
+
+    uint64_t PcapWriter::get_frames(void)
+    {
+        return this->frames;
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAP_WRITER_H_
+    #define _FRAME_PCAP_WRITER_H_
+
+    #include <Frame.h>
+    #include <FrameView.h>
+    #include <PcapFmt.h>
+
+    namespace Frames
+    {
+        const std::size_t PcapWriteBytes = 1 << 22;
+
+        class PcapWriter
+        {
+            private:
+                int         fd;
+                bool        nano;
+                uint32_t    snaplen;
+                BVec        buf;
+                std::size_t fill;
+                uint64_t    frames;
+
+                bool drain(const uint8_t *arg_bytes, std::size_t arg_len);
+
+            public:
+                PcapWriter(std::size_t arg_buf_len = PcapWriteBytes);
+                virtual ~PcapWriter(void);
+
+                bool open(std::string arg_path, bool arg_nano = false, uint32_t arg_snaplen = NicSnapLen);
+                bool write(const uint8_t *arg_bytes, uint32_t arg_len, const struct timespec &arg_ts, uint32_t arg_wire_len = 0);
+                bool write(const FrameView &arg_view);
+                bool write(Frame &arg_frame, const struct timespec &arg_ts);
+                bool write(Frame &arg_frame);
+                bool flush(void);
+                bool close(void);
+                uint64_t get_frames(void);
+        };
+    }
+#endif
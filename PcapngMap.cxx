@@ -0,0 +1,321 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <PcapngMap.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    PcapngMap::PcapngMap(void)
+    {
+        this->fd   = -1;
+        this->base = NULL;
+        this->size = 0;
+        this->pos  = 0;
+        this->swap = false;
+    }
+
+    PcapngMap::~PcapngMap(void)
+    {
+        this->close();
+    }
+
+    uint16_t PcapngMap::rd16(const uint8_t *arg_ptr) const
+    {
+        uint16_t val;
+
+        memcpy(&val, arg_ptr, sizeof(val));
+
+        return (this->swap) ? __builtin_bswap16(val) : val;
+    }
+
+    uint32_t PcapngMap::rd32(const uint8_t *arg_ptr) const
+    {
+        uint32_t val;
+
+        memcpy(&val, arg_ptr, sizeof(val));
+
+        return (this->swap) ? __builtin_bswap32(val) : val;
+    }
+
+    bool PcapngMap::parse_shb(const uint8_t *arg_blk, size_t arg_avail)
+    {
+        uint32_t order;
+
+        if (arg_avail < sizeof(ng_shb) + sizeof(uint32_t)) return false;
+
+        memcpy(&order, arg_blk + 8, sizeof(order));
+
+        if      (order == NgByteOrder)                    this->swap = false;
+        else if (order == __builtin_bswap32(NgByteOrder)) this->swap = true;
+        else return false;
+
+        if (this->rd16(arg_blk + 12) != NgVersMajor) return false;
+
+        // interface ids are scoped to their section
+        this->ifaces.clear();
+
+        return true;
+    }
+
+    void PcapngMap::parse_idb(const uint8_t *arg_blk, uint32_t arg_len)
+    {
+        ng_iface       iface;
+        const uint8_t *opt = arg_blk + sizeof(ng_idb);
+        const uint8_t *end = arg_blk + arg_len - sizeof(uint32_t);
+        uint16_t       code;
+        uint16_t       olen;
+        uint8_t        resol;
+
+        iface.linktype = this->rd16(arg_blk + 8);
+        iface.snaplen  = this->rd32(arg_blk + 12);
+        iface.units    = 1000000;
+
+        while (opt + 4 <= end)
+        {
+            code = this->rd16(opt);
+            olen = this->rd16(opt + 2);
+
+            if ((code == NgOptEnd) or (opt + 4 + olen > end)) break;
+
+            if (code == NgOptIfName)
+            {
+                iface.name.assign((const char *)opt + 4, olen);
+            }
+            else if ((code == NgOptTsresol) and (olen >= 1))
+            {
+                resol = opt[4];
+
+                // units per second must fit a uint64_t: 2^63 and 10^19 at most
+                if (((resol & 0x80) and (resol & 0x7F) > 63) or (not (resol & 0x80) and resol > 19))
+                {
+                    cerr << "PcapngMap::parse_idb(): ignoring invalid if_tsresol 0x" << hex << (unsigned)resol << dec << endl << flush;
+                }
+                else if (resol & 0x80)
+                {
+                    iface.units = 1ULL << (resol & 0x7F);
+                }
+                else
+                {
+                    iface.units = 1;
+
+                    for (uint8_t i = 0 ; i < resol ; i++) iface.units *= 10;
+                }
+            }
+
+            opt += 4 + ((olen + 3) & ~3);
+        }
+
+        this->ifaces.push_back(iface);
+    }
+
+    void PcapngMap::to_timespec(uint64_t arg_ts, uint64_t arg_units, struct timespec &arg_out) const
+    {
+        uint64_t frac = arg_ts % arg_units;
+
+        arg_out.tv_sec  = arg_ts / arg_units;
+        arg_out.tv_nsec = (uint64_t)(((unsigned __int128)frac * 1000000000ULL) / arg_units);
+    }
+
+    bool PcapngMap::open(string arg_path)
+    {
+        struct stat st;
+        void       *map;
+
+        this->close();
+
+        this->fd = ::open(arg_path.c_str(), O_RDONLY);
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapngMap::open(): failure opening " << arg_path << " " << strerror(errno) << endl << flush;
+            return false;
+        }
+
+        if ((fstat(this->fd, &st) < 0) or ((size_t)st.st_size < sizeof(ng_shb)))
+        {
+            cerr << "PcapngMap::open(): " << arg_path << " is too short for a section header" << endl << flush;
+            this->close();
+            return false;
+        }
+
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, this->fd, 0);
+
+        if (map == MAP_FAILED)
+        {
+            cerr << "PcapngMap::open(): mmap failure " << strerror(errno) << endl << flush;
+            this->close();
+            return false;
+        }
+
+        this->base = (const uint8_t *)map;
+        this->size = st.st_size;
+
+        if ((this->rd32(this->base) != NgBlockShb) or (not this->parse_shb(this->base, this->size)))
+        {
+            cerr << "PcapngMap::open(): " << arg_path << " does not start with a pcapng section header" << endl << flush;
+            this->close();
+            return false;
+        }
+
+        this->pos = 0;
+
+        this->advise(true);
+
+        return true;
+    }
+
+    void PcapngMap::close(void)
+    {
+        if (this->base != NULL)
+        {
+            munmap((void *)this->base, this->size);
+        }
+
+        if (this->fd >= 0)
+        {
+            ::close(this->fd);
+        }
+
+        this->fd   = -1;
+        this->base = NULL;
+        this->size = 0;
+        this->pos  = 0;
+        this->ifaces.clear();
+    }
+
+    void PcapngMap::advise(bool arg_sequential)
+    {
+        if (this->base == NULL) return;
+
+        madvise((void *)this->base, this->size, (arg_sequential) ? MADV_SEQUENTIAL : MADV_RANDOM);
+    }
+
+    bool PcapngMap::next(FrameView &arg_view, uint32_t &arg_if_id)
+    {
+        const uint8_t *blk;
+        uint32_t       type;
+        uint32_t       len;
+        uint32_t       caplen;
+        uint64_t       ts;
+
+        while (this->pos + sizeof(ng_block_hdr) <= this->size)
+        {
+            blk  = this->base + this->pos;
+            type = this->rd32(blk);
+
+            if ((type == NgBlockShb) and (not this->parse_shb(blk, this->size - this->pos)))
+            {
+                cerr << "PcapngMap::next(): bad section header at offset " << this->pos << endl << flush;
+                this->pos = this->size;
+                return false;
+            }
+
+            len = this->rd32(blk + 4);
+
+            if ((len < 12) or (len & 3) or (len > this->size - this->pos))
+            {
+                cerr << "PcapngMap::next(): bad block length at offset " << this->pos << endl << flush;
+                this->pos = this->size;
+                return false;
+            }
+
+            this->pos += len;
+
+            if ((type == NgBlockIdb) and (len >= sizeof(ng_idb) + 4))
+            {
+                this->parse_idb(blk, len);
+            }
+            else if ((type == NgBlockEpb) and (len >= sizeof(ng_epb) + 4))
+            {
+                arg_if_id = this->rd32(blk + 8);
+                caplen    = this->rd32(blk + 20);
+
+                if ((arg_if_id >= this->ifaces.size()) or (caplen > len - sizeof(ng_epb) - 4))
+                {
+                    cerr << "PcapngMap::next(): bad enhanced packet block at offset " << this->pos - len << endl << flush;
+                    continue;
+                }
+
+                ts = ((uint64_t)this->rd32(blk + 12) << 32) | this->rd32(blk + 16);
+
+                arg_view.data   = blk + sizeof(ng_epb);
+                arg_view.caplen = caplen;
+                arg_view.len    = this->rd32(blk + 24);
+
+                this->to_timespec(ts, this->ifaces[arg_if_id].units, arg_view.ts);
+
+                return true;
+            }
+            else if ((type == NgBlockSpb) and (len >= 16) and (not this->ifaces.empty()))
+            {
+                arg_if_id       = 0;
+                arg_view.len    = this->rd32(blk + 8);
+                caplen          = len - 16;
+                caplen          = (arg_view.len < caplen) ? arg_view.len : caplen;
+                caplen          = (this->ifaces[0].snaplen and (this->ifaces[0].snaplen < caplen)) ? this->ifaces[0].snaplen : caplen;
+
+                arg_view.data       = blk + 12;
+                arg_view.caplen     = caplen;
+                arg_view.ts.tv_sec  = 0;
+                arg_view.ts.tv_nsec = 0;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool PcapngMap::next(Frame &arg_frame, uint32_t &arg_if_id)
+    {
+        FrameView view;
+
+        if (not this->next(view, arg_if_id)) return false;
+
+        view.materialize(arg_frame);
+
+        return true;
+    }
+
+    void PcapngMap::rewind(void)
+    {
+        this->pos = 0;
+    }
+
+    uint32_t PcapngMap::get_if_count(void) const
+    {
+        return this->ifaces.size();
+    }
+
+    string PcapngMap::get_if_name(uint32_t arg_if_id) const
+    {
+        if (arg_if_id >= this->ifaces.size()) return string();
+
+        return this->ifaces[arg_if_id].name;
+    }
+}
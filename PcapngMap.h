@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAPNG_MAP_H_
+    #define _FRAME_PCAPNG_MAP_H_
+
+    #include <Frame.h>
+    #include <FrameView.h>
+    #include <PcapFmt.h>
+
+    namespace Frames
+    {
+        struct ng_iface
+        {
+            std::string name;
+            uint16_t    linktype;
+            uint32_t    snaplen;
+            uint64_t    units;
+        };
+
+        class PcapngMap
+        {
+            private:
+                int                   fd;
+                const uint8_t        *base;
+                std::size_t           size;
+                std::size_t           pos;
+                bool                  swap;
+                std::vector<ng_iface> ifaces;
+
+                uint16_t rd16(const uint8_t *arg_ptr) const;
+                uint32_t rd32(const uint8_t *arg_ptr) const;
+                bool parse_shb(const uint8_t *arg_blk, std::size_t arg_avail);
+                void parse_idb(const uint8_t *arg_blk, uint32_t arg_len);
+                void to_timespec(uint64_t arg_ts, uint64_t arg_units, struct timespec &arg_out) const;
+
+            public:
+                PcapngMap(void);
+                virtual ~PcapngMap(void);
+
+                bool open(std::string arg_path);
+                void close(void);
+                void advise(bool arg_sequential);
+                bool next(FrameView &arg_view, uint32_t &arg_if_id);
+                bool next(Frame &arg_frame, uint32_t &arg_if_id);
+                void rewind(void);
+                uint32_t get_if_count(void) const;
+                std::string get_if_name(uint32_t arg_if_id) const;
+        };
+    }
+#endif
@@ -0,0 +1,266 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <PcapngWriter.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    static size_t pad4(size_t arg_len)
+    {
+        return (arg_len + 3) & ~(size_t)3;
+    }
+
+    PcapngWriter::PcapngWriter(size_t arg_buf_len)
+    {
+        this->fd       = -1;
+        this->fill     = 0;
+        this->if_count = 0;
+        this->frames   = 0;
+
+        this->buf.resize(arg_buf_len);
+    }
+
+    PcapngWriter::~PcapngWriter(void)
+    {
+        this->close();
+    }
+
+    bool PcapngWriter::drain(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        ssize_t ret;
+
+        while (arg_len > 0)
+        {
+            ret = ::write(this->fd, arg_bytes, arg_len);
+
+            if (ret < 0)
+            {
+                if (errno == EINTR) continue;
+
+                cerr << "PcapngWriter::drain(): write failure " << strerror(errno) << endl << std::flush;
+                return false;
+            }
+
+            arg_bytes += ret;
+            arg_len   -= ret;
+        }
+
+        return true;
+    }
+
+    uint8_t * PcapngWriter::reserve(size_t arg_len)
+    {
+        uint8_t *ptr;
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapngWriter::reserve(): file is not open" << endl << std::flush;
+            return NULL;
+        }
+
+        if (this->fill + arg_len > this->buf.size())
+        {
+            if (not this->flush()) return NULL;
+        }
+
+        if (arg_len > this->buf.size())
+        {
+            this->buf.resize(arg_len);
+        }
+
+        ptr         = this->buf.data() + this->fill;
+        this->fill += arg_len;
+
+        return ptr;
+    }
+
+    void PcapngWriter::put_opt(uint8_t *&arg_ptr, uint16_t arg_code, const void *arg_val, uint16_t arg_len)
+    {
+        size_t len = pad4(arg_len);
+
+        memcpy(arg_ptr + 0, &arg_code, 2);
+        memcpy(arg_ptr + 2, &arg_len,  2);
+        memset(arg_ptr + 4, 0, len);
+
+        if (arg_len) memcpy(arg_ptr + 4, arg_val, arg_len);
+
+        arg_ptr += 4 + len;
+    }
+
+    bool PcapngWriter::open(string arg_path)
+    {
+        ng_shb   shb;
+        uint32_t len = sizeof(shb) + sizeof(uint32_t);
+        uint8_t *ptr;
+
+        this->close();
+
+        this->fd = ::open(arg_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (this->fd < 0)
+        {
+            cerr << "PcapngWriter::open(): failure opening " << arg_path << " " << strerror(errno) << endl << std::flush;
+            return false;
+        }
+
+        this->fill     = 0;
+        this->if_count = 0;
+        this->frames   = 0;
+
+        shb.hdr.type    = NgBlockShb;
+        shb.hdr.len     = len;
+        shb.byte_order  = NgByteOrder;
+        shb.vers_major  = NgVersMajor;
+        shb.vers_minor  = NgVersMinor;
+        shb.section_len = -1;
+
+        ptr = this->reserve(len);
+
+        memcpy(ptr, &shb, sizeof(shb));
+        memcpy(ptr + sizeof(shb), &len, sizeof(len));
+
+        return true;
+    }
+
+    int PcapngWriter::add_interface(string arg_name, uint32_t arg_snaplen, uint16_t arg_linktype)
+    {
+        ng_idb   idb;
+        uint32_t len;
+        uint8_t *ptr;
+        uint8_t  tsresol = NgTsresolNsec;
+
+        len  = sizeof(idb);
+        len += 4 + pad4(arg_name.size());
+        len += 4 + pad4(sizeof(tsresol));
+        len += 4 + sizeof(uint32_t);
+
+        ptr = this->reserve(len);
+
+        if (ptr == NULL) return -1;
+
+        idb.hdr.type = NgBlockIdb;
+        idb.hdr.len  = len;
+        idb.linktype = arg_linktype;
+        idb.reserved = 0;
+        idb.snaplen  = arg_snaplen;
+
+        memcpy(ptr, &idb, sizeof(idb));
+        ptr += sizeof(idb);
+
+        this->put_opt(ptr, NgOptIfName,  arg_name.data(), arg_name.size());
+        this->put_opt(ptr, NgOptTsresol, &tsresol, sizeof(tsresol));
+        this->put_opt(ptr, NgOptEnd,     NULL, 0);
+
+        memcpy(ptr, &len, sizeof(len));
+
+        return this->if_count++;
+    }
+
+    bool PcapngWriter::write(uint32_t arg_if_id, const uint8_t *arg_bytes, uint32_t arg_len, const struct timespec &arg_ts, uint32_t arg_wire_len)
+    {
+        ng_epb   epb;
+        uint64_t ts_ns = ((uint64_t)arg_ts.tv_sec * 1000000000ULL) + arg_ts.tv_nsec;
+        uint32_t len   = sizeof(epb) + pad4(arg_len) + sizeof(uint32_t);
+        uint8_t *ptr;
+
+        if (arg_if_id >= this->if_count)
+        {
+            cerr << "PcapngWriter::write(): interface " << arg_if_id << " has not been added" << endl << std::flush;
+            return false;
+        }
+
+        ptr = this->reserve(len);
+
+        if (ptr == NULL) return false;
+
+        epb.hdr.type = NgBlockEpb;
+        epb.hdr.len  = len;
+        epb.if_id    = arg_if_id;
+        epb.ts_high  = ts_ns >> 32;
+        epb.ts_low   = ts_ns & 0xFFFFFFFF;
+        epb.caplen   = arg_len;
+        epb.len      = (arg_wire_len > arg_len) ? arg_wire_len : arg_len;
+
+        memcpy(ptr, &epb, sizeof(epb));
+        ptr += sizeof(epb);
+
+        memcpy(ptr, arg_bytes, arg_len);
+        memset(ptr + arg_len, 0, pad4(arg_len) - arg_len);
+        ptr += pad4(arg_len);
+
+        memcpy(ptr, &len, sizeof(len));
+
+        this->frames++;
+
+        return true;
+    }
+
+    bool PcapngWriter::write(uint32_t arg_if_id, const FrameView &arg_view)
+    {
+        return this->write(arg_if_id, arg_view.data, arg_view.caplen, arg_view.ts, arg_view.len);
+    }
+
+    bool PcapngWriter::write(uint32_t arg_if_id, Frame &arg_frame, const struct timespec &arg_ts)
+    {
+        const BVec &bytes = arg_frame.peek_frame();
+
+        return this->write(arg_if_id, bytes.data(), bytes.size(), arg_ts);
+    }
+
+    bool PcapngWriter::flush(void)
+    {
+        bool okay = true;
+
+        if (this->fd < 0) return false;
+
+        if (this->fill > 0)
+        {
+            okay       = this->drain(this->buf.data(), this->fill);
+            this->fill = 0;
+        }
+
+        return okay;
+    }
+
+    bool PcapngWriter::close(void)
+    {
+        bool okay = true;
+
+        if (this->fd < 0) return true;
+
+        okay = this->flush();
+
+        ::close(this->fd);
+        this->fd = -1;
+
+        return okay;
+    }
+
+    uint64_t PcapngWriter::get_frames(void)
+    {
+        return this->frames;
+    }
+}
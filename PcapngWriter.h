@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_PCAPNG_WRITER_H_
+    #define _FRAME_PCAPNG_WRITER_H_
+
+    #include <Frame.h>
+    #include <FrameView.h>
+    #include <PcapFmt.h>
+
+    namespace Frames
+    {
+        const std::size_t NgWriteBytes = 1 << 22;
+
+        class PcapngWriter
+        {
+            private:
+                int         fd;
+                BVec        buf;
+                std::size_t fill;
+                uint32_t    if_count;
+                uint64_t    frames;
+
+                bool drain(const uint8_t *arg_bytes, std::size_t arg_len);
+                uint8_t * reserve(std::size_t arg_len);
+                void put_opt(uint8_t *&arg_ptr, uint16_t arg_code, const void *arg_val, uint16_t arg_len);
+
+            public:
+                PcapngWriter(std::size_t arg_buf_len = NgWriteBytes);
+                virtual ~PcapngWriter(void);
+
+                bool open(std::string arg_path);
+                int  add_interface(std::string arg_name, uint32_t arg_snaplen = NicSnapLen, uint16_t arg_linktype = PcapLinkEth);
+                bool write(uint32_t arg_if_id, const uint8_t *arg_bytes, uint32_t arg_len, const struct timespec &arg_ts, uint32_t arg_wire_len = 0);
+                bool write(uint32_t arg_if_id, const FrameView &arg_view);
+                bool write(uint32_t arg_if_id, Frame &arg_frame, const struct timespec &arg_ts);
+                bool flush(void);
+                bool close(void);
+                uint64_t get_frames(void);
+        };
+    }
+#endif
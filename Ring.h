@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_RING_H_
+    #define _FRAME_RING_H_
+
+    #include <atomic>
+    #include <cstddef>
+    #include <vector>
+
+    namespace Frames
+    {
+        const std::size_t RingLineBytes = 64;
+
+        // Bounded single-producer/single-consumer ring.  Slots stay in place so
+        // that a producer can fill, and a consumer can read, a slot without
+        // copying it; the *_slot() calls reserve and the *_commit() calls publish.
+
+        template <typename T>
+        class SpscRing
+        {
+            private:
+                std::vector<T>                                slots;
+                std::size_t                                   mask;
+                alignas(RingLineBytes) std::atomic<std::size_t> head;
+                alignas(RingLineBytes) std::atomic<std::size_t> tail;
+
+            public:
+                SpscRing(std::size_t arg_depth)
+                {
+                    std::size_t depth = 1;
+
+                    while (depth < arg_depth) depth <<= 1;
+
+                    this->slots.resize(depth);
+                    this->mask = depth - 1;
+                    this->head.store(0, std::memory_order_relaxed);
+                    this->tail.store(0, std::memory_order_relaxed);
+                }
+
+                std::size_t depth(void) const
+                {
+                    return this->mask + 1;
+                }
+
+                std::size_t occupancy(void) const
+                {
+                    // head first: tail only grows, so it can never read behind it
+                    std::size_t pos = this->head.load(std::memory_order_acquire);
+                    std::size_t len = this->tail.load(std::memory_order_acquire) - pos;
+
+                    return (len > this->mask) ? this->mask + 1 : len;
+                }
+
+                T * push_slot(void)
+                {
+                    std::size_t pos = this->tail.load(std::memory_order_relaxed);
+
+                    if (pos - this->head.load(std::memory_order_acquire) > this->mask) return NULL;
+
+                    return &this->slots[pos & this->mask];
+                }
+
+                void push_commit(void)
+                {
+                    this->tail.store(this->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                }
+
+                T * pop_slot(void)
+                {
+                    std::size_t pos = this->head.load(std::memory_order_relaxed);
+
+                    if (pos == this->tail.load(std::memory_order_acquire)) return NULL;
+
+                    return &this->slots[pos & this->mask];
+                }
+
+                void pop_commit(void)
+                {
+                    this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                }
+        };
+    }
+#endif
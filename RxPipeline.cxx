@@ -0,0 +1,371 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <RxPipeline.h>
+
+namespace Frames
+{
+    using namespace std;
+
+    RxPipeline::pipe_worker::pipe_worker(unsigned arg_depth) : ring(arg_depth)
+    {
+        this->cpu = PipeNoCpu;
+        this->frames.store(0, memory_order_relaxed);
+        this->drops.store(0, memory_order_relaxed);
+        this->blocks.store(0, memory_order_relaxed);
+        this->high_water.store(0, memory_order_relaxed);
+        this->handled.store(0, memory_order_relaxed);
+    }
+
+    RxPipeline::RxPipeline(unsigned arg_workers, unsigned arg_depth, PipePolicy arg_policy)
+    {
+        if ((arg_workers == 0) or (arg_workers > PipeMaxWorkers))
+        {
+            cerr << "[ERR] RxPipeline(): worker count must be 1 to " << PipeMaxWorkers << endl << flush;
+            exit(1);
+        }
+
+        // plain new does not honour the line alignment of the counters before C++17
+        for (unsigned i = 0; i < arg_workers; i++)
+        {
+            void *mem = NULL;
+
+            if (posix_memalign(&mem, RingLineBytes, sizeof(pipe_worker)) != 0)
+            {
+                cerr << "[ERR] RxPipeline(): worker allocation failure" << endl << flush;
+                exit(1);
+            }
+
+            this->workers.push_back(new (mem) pipe_worker(arg_depth));
+        }
+
+        this->nic           = NULL;
+        this->policy        = arg_policy;
+        this->burst         = PipeBurst;
+        this->next_worker   = 0;
+        this->capture_cpu   = PipeNoCpu;
+        this->stop_on_empty = false;
+        this->running       = false;
+        this->captured.store(0, memory_order_relaxed);
+        this->stop_req.store(false, memory_order_relaxed);
+        this->capture_done.store(false, memory_order_relaxed);
+    }
+
+    RxPipeline::~RxPipeline(void)
+    {
+        this->stop();
+
+        for (pipe_worker *w : this->workers)
+        {
+            w->~pipe_worker();
+            free(w);
+        }
+    }
+
+    void RxPipeline::set_capture_cpu(int arg_cpu)
+    {
+        this->capture_cpu = arg_cpu;
+    }
+
+    bool RxPipeline::set_worker_cpu(unsigned arg_worker, int arg_cpu)
+    {
+        if (arg_worker >= this->workers.size())
+        {
+            cerr << "[ERR] RxPipeline::set_worker_cpu(): no worker " << arg_worker << endl << flush;
+            return false;
+        }
+
+        this->workers[arg_worker]->cpu = arg_cpu;
+
+        return true;
+    }
+
+    void RxPipeline::set_burst(unsigned arg_burst)
+    {
+        this->burst = (arg_burst == 0) ? 1 : arg_burst;
+    }
+
+    // A live nic returns an empty burst on its read timeout, an offline one
+    // only at end of file; only the latter should end the capture.
+
+    void RxPipeline::set_stop_on_empty(bool arg_stop)
+    {
+        this->stop_on_empty = arg_stop;
+    }
+
+    void RxPipeline::set_dispatch(PipeDispatch arg_dispatch)
+    {
+        this->dispatcher = arg_dispatch;
+    }
+
+    // arg_hash is used by reference and must outlive the pipeline's run.
+
+    void RxPipeline::set_flow_hash(const FlowHash &arg_hash)
+    {
+        const FlowHash *fh = &arg_hash;
+
+        this->dispatcher = [fh](const uint8_t *arg_bytes, size_t arg_len)
+        {
+            return fh->hash(arg_bytes, arg_len);
+        };
+    }
+
+    void RxPipeline::pin(const char *arg_who, int arg_cpu)
+    {
+        cpu_set_t set;
+        int       ret;
+
+        if (arg_cpu == PipeNoCpu) return;
+
+        CPU_ZERO(&set);
+        CPU_SET(arg_cpu, &set);
+
+        ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+        if (ret != 0)
+        {
+            cerr << "[ERR] RxPipeline::pin(): cannot pin " << arg_who << " to cpu " << arg_cpu << endl << flush;
+        }
+    }
+
+    unsigned RxPipeline::pick(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        unsigned idx;
+
+        if (this->dispatcher) return FlowHash::pick(this->dispatcher(arg_bytes, arg_len), this->workers.size());
+
+        idx = this->next_worker;
+
+        if (++this->next_worker == this->workers.size()) this->next_worker = 0;
+
+        return idx;
+    }
+
+    void RxPipeline::dispatch(const uint8_t *arg_bytes, size_t arg_len)
+    {
+        pipe_worker *w = this->workers[this->pick(arg_bytes, arg_len)];
+        Buf         *slot;
+        size_t       occ;
+
+        w->frames.store(w->frames.load(memory_order_relaxed) + 1, memory_order_relaxed);
+
+        slot = w->ring.push_slot();
+
+        if ((slot == NULL) and (this->policy == PipePolicy::POLICY_BLOCK))
+        {
+            w->blocks.store(w->blocks.load(memory_order_relaxed) + 1, memory_order_relaxed);
+
+            while ((slot == NULL) and not this->stop_req.load(memory_order_relaxed))
+            {
+                this_thread::yield();
+                slot = w->ring.push_slot();
+            }
+        }
+
+        if (slot == NULL)
+        {
+            w->drops.store(w->drops.load(memory_order_relaxed) + 1, memory_order_relaxed);
+            return;
+        }
+
+        slot->assign(arg_bytes, arg_len);
+        w->ring.push_commit();
+
+        occ = w->ring.occupancy();
+
+        if (occ > w->high_water.load(memory_order_relaxed)) w->high_water.store(occ, memory_order_relaxed);
+    }
+
+    void RxPipeline::capture_loop(void)
+    {
+        ViewHandler handler = [this](const FrameView &arg_view)
+        {
+            this->dispatch(arg_view.data, arg_view.caplen);
+        };
+        int ret;
+
+        pin("capture", this->capture_cpu);
+
+        while (not this->stop_req.load(memory_order_relaxed))
+        {
+            ret = this->nic->rx_view(this->burst, handler);
+
+            if (ret < 0)
+            {
+                cerr << "[ERR] RxPipeline::capture_loop(): nic receive failure" << endl << flush;
+                break;
+            }
+
+            if ((ret == 0) and this->stop_on_empty) break;
+
+            this->captured.store(this->captured.load(memory_order_relaxed) + ret, memory_order_relaxed);
+        }
+
+        this->capture_done.store(true, memory_order_release);
+    }
+
+    void RxPipeline::worker_loop(unsigned arg_index)
+    {
+        pipe_worker *w = this->workers[arg_index];
+        Buf         *slot;
+
+        pin("worker", w->cpu);
+
+        while (true)
+        {
+            slot = w->ring.pop_slot();
+
+            if (slot == NULL)
+            {
+                // the ring must be checked again after the capture side is seen
+                // done, since its last commit may have landed in between
+                if (this->capture_done.load(memory_order_acquire))
+                {
+                    if (w->ring.pop_slot() == NULL) break;
+                    continue;
+                }
+
+                this_thread::yield();
+                continue;
+            }
+
+            this->handler(arg_index, *slot);
+            w->ring.pop_commit();
+            w->handled.store(w->handled.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        }
+    }
+
+    bool RxPipeline::start(Nic &arg_nic, PipeHandler arg_handler)
+    {
+        if (this->running)
+        {
+            cerr << "[ERR] RxPipeline::start(): pipeline is already running" << endl << flush;
+            return false;
+        }
+
+        if (not arg_handler)
+        {
+            cerr << "[ERR] RxPipeline::start(): handler is empty" << endl << flush;
+            return false;
+        }
+
+        this->nic         = &arg_nic;
+        this->handler     = arg_handler;
+        this->next_worker = 0;
+        this->captured.store(0, memory_order_relaxed);
+        this->stop_req.store(false, memory_order_relaxed);
+        this->capture_done.store(false, memory_order_relaxed);
+
+        for (unsigned i = 0; i < this->workers.size(); i++)
+        {
+            this->workers[i]->thread = thread(&RxPipeline::worker_loop, this, i);
+        }
+
+        this->capture = thread(&RxPipeline::capture_loop, this);
+        this->running = true;
+
+        return true;
+    }
+
+    void RxPipeline::join(void)
+    {
+        if (not this->running) return;
+
+        this->capture.join();
+
+        for (pipe_worker *w : this->workers) w->thread.join();
+
+        this->running = false;
+    }
+
+    void RxPipeline::wait(void)
+    {
+        this->join();
+    }
+
+    void RxPipeline::stop(void)
+    {
+        this->stop_req.store(true, memory_order_relaxed);
+        this->join();
+    }
+
+    bool RxPipeline::is_running(void)
+    {
+        return this->running;
+    }
+
+    unsigned RxPipeline::get_workers(void)
+    {
+        return this->workers.size();
+    }
+
+    size_t RxPipeline::get_depth(void)
+    {
+        return this->workers[0]->ring.depth();
+    }
+
+    bool RxPipeline::get_worker_stats(unsigned arg_worker, pipe_stats &arg_stats)
+    {
+        pipe_worker *w;
+
+        if (arg_worker >= this->workers.size())
+        {
+            cerr << "[ERR] RxPipeline::get_worker_stats(): no worker " << arg_worker << endl << flush;
+            return false;
+        }
+
+        w = this->workers[arg_worker];
+
+        arg_stats.captured   = 0;
+        arg_stats.frames     = w->frames.load(memory_order_relaxed);
+        arg_stats.drops      = w->drops.load(memory_order_relaxed);
+        arg_stats.blocks     = w->blocks.load(memory_order_relaxed);
+        arg_stats.handled    = w->handled.load(memory_order_relaxed);
+        arg_stats.occupancy  = w->ring.occupancy();
+        arg_stats.high_water = w->high_water.load(memory_order_relaxed);
+
+        return true;
+    }
+
+    void RxPipeline::get_stats(pipe_stats &arg_stats)
+    {
+        pipe_stats ws;
+
+        arg_stats          = {0, 0, 0, 0, 0, 0, 0};
+        arg_stats.captured = this->captured.load(memory_order_relaxed);
+
+        for (unsigned i = 0; i < this->workers.size(); i++)
+        {
+            this->get_worker_stats(i, ws);
+
+            arg_stats.frames    += ws.frames;
+            arg_stats.drops     += ws.drops;
+            arg_stats.blocks    += ws.blocks;
+            arg_stats.handled   += ws.handled;
+            arg_stats.occupancy += ws.occupancy;
+
+            if (ws.high_water > arg_stats.high_water) arg_stats.high_water = ws.high_water;
+        }
+    }
+}
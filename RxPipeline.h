@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2020-2021 Robert Newgard
+ *
+ *  This file is part of CxxFrames.
+ *
+ *  CxxFrames is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  CxxFrames is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with CxxFrames.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FRAME_RX_PIPELINE_H_
+    #define _FRAME_RX_PIPELINE_H_
+
+    #include <atomic>
+    #include <cstdint>
+    #include <functional>
+    #include <thread>
+    #include <vector>
+    #include <Nic.h>
+    #include <Ring.h>
+    #include <FlowHash.h>
+
+    namespace Frames
+    {
+        const unsigned PipeMaxWorkers = 64;
+        const unsigned PipeDepth      = 1024;
+        const unsigned PipeBurst      = 32;
+        const int      PipeNoCpu      = -1;
+
+        enum class PipePolicy : uint8_t
+        {
+            POLICY_DROP  = 0x00,
+            POLICY_BLOCK = 0x01
+        };
+
+        // captured counts frames read from the nic; it is pipeline-wide, so
+        // get_worker_stats() leaves it zero.
+        struct pipe_stats
+        {
+            uint64_t    captured;
+            uint64_t    frames;
+            uint64_t    drops;
+            uint64_t    blocks;
+            uint64_t    handled;
+            std::size_t occupancy;
+            std::size_t high_water;
+        };
+
+        typedef std::function<void(unsigned arg_worker, Buf &arg_buf)> PipeHandler;
+        typedef std::function<uint32_t(const uint8_t *arg_bytes, std::size_t arg_len)> PipeDispatch;
+
+        // One capture thread reads the nic and copies each frame into a slot of
+        // a worker's SPSC ring; each worker drains its own ring into the handler.
+        // Counters on the capture side and the worker side sit on separate lines
+        // so that neither thread writes a line the other one is polling.
+        // Frames go round-robin unless a dispatch hash is set, in which case
+        // FlowHash::pick() maps each frame's hash onto a worker, keeping every
+        // flow on one worker.  Frames are hashed one at a time, since a view is
+        // only valid inside its rx_view() callback; FlowHash::hash_batch() is
+        // for callers that hold a whole burst.
+
+        class RxPipeline
+        {
+            private:
+                struct pipe_worker
+                {
+                    SpscRing<Buf>                                 ring;
+                    std::thread                                   thread;
+                    int                                           cpu;
+                    alignas(RingLineBytes) std::atomic<uint64_t>  frames;
+                    std::atomic<uint64_t>                         drops;
+                    std::atomic<uint64_t>                         blocks;
+                    std::atomic<std::size_t>                      high_water;
+                    alignas(RingLineBytes) std::atomic<uint64_t>  handled;
+
+                    pipe_worker(unsigned arg_depth);
+                };
+
+                std::vector<pipe_worker *> workers;
+                std::thread                capture;
+                Nic                       *nic;
+                PipeHandler                handler;
+                PipeDispatch               dispatcher;
+                PipePolicy                 policy;
+                unsigned                   burst;
+                unsigned                   next_worker;
+                int                        capture_cpu;
+                bool                       stop_on_empty;
+                bool                       running;
+                std::atomic<uint64_t>      captured;
+                std::atomic<bool>          stop_req;
+                std::atomic<bool>          capture_done;
+
+                static void pin(const char *arg_who, int arg_cpu);
+                unsigned pick(const uint8_t *arg_bytes, std::size_t arg_len);
+                void dispatch(const uint8_t *arg_bytes, std::size_t arg_len);
+                void capture_loop(void);
+                void worker_loop(unsigned arg_index);
+                void join(void);
+
+            public:
+                RxPipeline(unsigned arg_workers, unsigned arg_depth = PipeDepth, PipePolicy arg_policy = PipePolicy::POLICY_DROP);
+                ~RxPipeline(void);
+
+                void set_capture_cpu(int arg_cpu);
+                bool set_worker_cpu(unsigned arg_worker, int arg_cpu);
+                void set_burst(unsigned arg_burst);
+                void set_stop_on_empty(bool arg_stop);
+                void set_dispatch(PipeDispatch arg_dispatch);
+                void set_flow_hash(const FlowHash &arg_hash);
+
+                bool start(Nic &arg_nic, PipeHandler arg_handler);
+                void wait(void);
+                void stop(void);
+                bool is_running(void);
+
+                unsigned get_workers(void);
+                std::size_t get_depth(void);
+                void get_stats(pipe_stats &arg_stats);
+                bool get_worker_stats(unsigned arg_worker, pipe_stats &arg_stats);
+        };
+    }
+#endif